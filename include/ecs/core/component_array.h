@@ -1,24 +1,227 @@
 #pragma once
+#include <algorithm>
 #include <array>
-#include <unordered_map>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <memory_resource>
 
 #include <ecs/core/types.h>
 #include <ecs/core/component_layout.h>
 
 namespace ecs::core {
+	// Opt-in change tracking, specialize with enabled = true. Tracked arrays stamp
+	// every slot with the current tick on Add and on mutable access.
+	template<typename T>
+	struct TrackChanges {
+		static constexpr bool enabled = false;
+	};
+
+	enum class SortAlgorithm {
+		// std::sort of an index permutation, applied with one swap per misplaced component
+		full,
+		// in place, cheap for arrays that are nearly sorted from the last frame
+		insertion,
+	};
+
 	class ComponentBase {
 	public:
 		virtual ~ComponentBase() = default;
 		virtual void DestroyEntity(Entity entity) = 0;
+		virtual size_t Size() const = 0;
+		virtual result<Entity> EntityAt(size_t index) const = 0;
+		virtual void Clear() = 0;
+		// Writes the index table and the dense component block
+		virtual err Save(Snapshot& snapshot) const = 0;
+		virtual err Load(SnapshotReader& reader) = 0;
+		// Reads what Load would without changing anything, the stored entities have to own type in entities
+		virtual err Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const = 0;
+		// Tick stamped on changes, ignored by untracked arrays
+		virtual void SetTick(Version tick) = 0;
+		// Whether the i-th stored component sits at index i instead of at its entity id
+		virtual bool Packed() const = 0;
+		// Array index of the component of entity
+		virtual result<size_t> IndexOf(Entity entity) const = 0;
+		// Exchanges two stored components with their entities, packed arrays only
+		virtual err Swap(size_t first, size_t second) = 0;
+		// Stored entities in iteration order
+		virtual const Entity* Entities() const = 0;
+
+		// Moves the entities stored in other to the front, in the order of other.
+		// The remaining entities follow in no particular order.
+		err SortAs(const ComponentBase& other) {
+			if (!Packed()) {
+				return err::invalid_argument;
+			}
+			size_t position = 0;
+			for (size_t index = 0; index < other.Size(); index++) {
+				if (const auto own = IndexOf(other.EntityAt(index).data); own.error == err::ok) {
+					Swap(own.data, position++);
+				}
+			}
+			return err::ok;
+		}
+	};
+
+	// Typed access to the components of one type, independent of the layout
+	template<typename T>
+	class ComponentStorage : public ComponentBase {
+	protected:
+		static constexpr bool tracked = TrackChanges<T>::enabled;
+
+		std::array<T, MAX_ENTITY_COUNT> components_{};
+		// version per slot, empty for untracked types
+		std::array<Version, tracked ? MAX_ENTITY_COUNT : 0> versions_{};
+		Version tick_{ 0 };
+		// permutation scratch of the full sort, kept so sorting every frame does not allocate
+		std::pmr::vector<size_t> sort_order_;
+
+		explicit ComponentStorage(std::pmr::memory_resource* resource) :
+			sort_order_(resource) {}
+
+		void stamp(size_t index) {
+			if constexpr (tracked) {
+				versions_[index] = tick_;
+			}
+		}
+
+	public:
+		virtual err Add(Entity entity, const T& component) = 0;
+		// Adds copies of component for count entities without components of this type
+		virtual err AddMany(const Entity* entities, size_t count, const T& component) = 0;
+		virtual result<T> Get(Entity entity) const = 0;
+		// Stamps the component as changed
+		virtual result<T*> GetMutable(Entity entity) = 0;
+		virtual err Remove(Entity entity) = 0;
+		// Tick of the last change, 0 for untracked types
+		virtual Version VersionOf(Entity entity) const = 0;
+
+		virtual void SetTick(Version tick) override {
+			tick_ = tick;
+		}
+
+		// Orders the components of a packed array by compare(const T&, const T&)
+		template<typename Compare>
+		err Sort(Compare compare, SortAlgorithm algorithm = SortAlgorithm::full) {
+			if (!Packed()) {
+				return err::invalid_argument;
+			}
+			const auto size = Size();
+			if (algorithm == SortAlgorithm::insertion) {
+				for (size_t index = 1; index < size; index++) {
+					for (auto position = index; position > 0 && compare(components_[position], components_[position - 1]); position--) {
+						Swap(position, position - 1);
+					}
+				}
+				return err::ok;
+			}
+
+			// order[position] is the index of the component that belongs to position
+			auto& order = sort_order_;
+			order.resize(size);
+			std::iota(order.begin(), order.end(), size_t{ 0 });
+			std::sort(order.begin(), order.end(), [this, &compare](size_t first, size_t second) {
+				return compare(components_[first], components_[second]);
+			});
+			// walk every cycle of the permutation, placed positions are marked with order[i] == i
+			for (size_t start = 0; start < size; start++) {
+				auto current = start;
+				while (order[current] != start) {
+					const auto next = order[current];
+					order[current] = current;
+					Swap(current, next);
+					current = next;
+				}
+				order[current] = current;
+			}
+			return err::ok;
+		}
+
+		// First count components of a packed array, tracked ones are stamped as changed
+		T* MutableData(size_t count) {
+			if constexpr (tracked) {
+				for (size_t index = 0; index < count; index++) {
+					stamp(index);
+				}
+			}
+			return components_.data();
+		}
+
+		// Calls fn(entity, component) for every stored component in array order,
+		// tracked components are all stamped as changed. Callbacks taking a const
+		// component only read, they go to the const overload and stamp nothing.
+		template<typename F>
+		void ForEach(F&& fn) {
+			if constexpr (std::is_invocable_v<F&, Entity, const T&>) {
+				std::as_const(*this).ForEach(std::forward<F>(fn));
+			}
+			else {
+				const auto size = Size();
+				const auto* stored = Entities();
+				const auto dense = Packed();
+				for (size_t position = 0; position < size; position++) {
+					const auto index = dense ? position : stored[position];
+					fn(stored[position], components_[index]);
+					stamp(index);
+				}
+			}
+		}
+
+		// Calls fn(entity, const component&) for every stored component in array order
+		template<typename F>
+		void ForEach(F&& fn) const {
+			const auto size = Size();
+			const auto* stored = Entities();
+			const auto dense = Packed();
+			for (size_t position = 0; position < size; position++) {
+				const auto index = dense ? position : stored[position];
+				fn(stored[position], static_cast<const T&>(components_[index]));
+			}
+		}
+
+		// Calls fn(entity, component) for components changed at or after tick since.
+		// Only the version array is scanned, unchanged components are not touched.
+		template<typename F>
+		void ForEachChanged(Version since, F&& fn) const {
+			static_assert(tracked, "Change tracking is not enabled for this component, see TrackChanges");
+			const auto size = Size();
+			const auto* stored = Entities();
+			const auto dense = Packed();
+			for (size_t position = 0; position < size; position++) {
+				const auto index = dense ? position : stored[position];
+				if (versions_[index] >= since) {
+					fn(stored[position], static_cast<const T&>(components_[index]));
+				}
+			}
+		}
 	};
 
 	template<typename T, typename MemoryLayout>
-	class ComponentArray : public ComponentBase {
+	class ComponentArray : public ComponentStorage<T> {
+		using Base = ComponentStorage<T>;
+		using Base::tracked;
+		using Base::components_;
+		using Base::versions_;
+		using Base::stamp;
 	private:
-		std::array<T, MAX_ENTITY_COUNT> components_{};
-		MemoryLayout memory_layout_{};
+		MemoryLayout memory_layout_;
+
+		// Component index of the i-th stored entity
+		size_t indexAt(size_t position) const {
+			if constexpr (MemoryLayout::packed) {
+				return position;
+			}
+			else {
+				return memory_layout_.Entities()[position];
+			}
+		}
 	public:
-		err Add(Entity entity, const T& component) {
+		explicit ComponentArray(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			Base(resource),
+			memory_layout_(resource) {}
+
+		virtual err Add(Entity entity, const T& component) override {
 			const result<size_t> result = memory_layout_.Add(entity);
 
 			if(result.error != err::ok) {
@@ -27,10 +230,39 @@ namespace ecs::core {
 			
 			const auto new_index = result.data;
 			components_[new_index] = component;
+			stamp(new_index);
 			return err::ok;
 		}
 
-		result<T> Get(Entity entity) const {
+		// Packed layouts place the new components in one contiguous block
+		virtual err AddMany(const Entity* entities, size_t count, const T& component) override {
+			if (memory_layout_.Size() + count > MAX_ENTITY_COUNT) {
+				return err::entity_limit;
+			}
+			const auto first = memory_layout_.Size();
+			for (size_t index = 0; index < count; index++) {
+				const auto result = memory_layout_.Add(entities[index]);
+				if (result.error != err::ok) {
+					for (size_t added = 0; added < index; added++) {
+						Remove(entities[added]);
+					}
+					return result.error;
+				}
+				if constexpr (!MemoryLayout::packed) {
+					components_[result.data] = component;
+					stamp(result.data);
+				}
+			}
+			if constexpr (MemoryLayout::packed) {
+				std::fill_n(components_.begin() + first, count, component);
+				for (auto index = first; index < first + count; index++) {
+					stamp(index);
+				}
+			}
+			return err::ok;
+		}
+
+		virtual result<T> Get(Entity entity) const override {
 			const auto result = memory_layout_.Get(entity);
 			if(result.error != err::ok) {
 				return {result.error};
@@ -38,24 +270,171 @@ namespace ecs::core {
 			return {components_[result.data]};
 		}
 
-		err Remove(Entity entity) {
+		virtual result<T*> GetMutable(Entity entity) override {
+			const auto result = memory_layout_.Get(entity);
+			if(result.error != err::ok) {
+				return {result.error};
+			}
+			stamp(result.data);
+			return {&components_[result.data]};
+		}
+
+		virtual err Remove(Entity entity) override {
 			const result<size_t> result = memory_layout_.Remove(entity);
 
 			if(result.error != err::ok) {
 				return result.error;
 			}
 
-			const auto index_last_entity = memory_layout_.Size();
-			const auto index_removed_entity = result.data;
+			if constexpr (MemoryLayout::packed) {
+				const auto index_last_entity = memory_layout_.Size();
+				const auto index_removed_entity = result.data;
 
-			components_[index_removed_entity] = components_[index_last_entity];
+				components_[index_removed_entity] = components_[index_last_entity];
+				if constexpr (tracked) {
+					versions_[index_removed_entity] = versions_[index_last_entity];
+				}
+			}
+			return err::ok;
+		}
+
+		virtual const Entity* Entities() const override {
+			return memory_layout_.Entities();
+		}
+
+		virtual bool Packed() const override {
+			return MemoryLayout::packed;
+		}
+
+		virtual result<size_t> IndexOf(Entity entity) const override {
+			return memory_layout_.Get(entity);
+		}
+
+		virtual err Swap(size_t first, size_t second) override {
+			if (const auto error = memory_layout_.Swap(first, second); error != err::ok) {
+				return error;
+			}
+			std::swap(components_[first], components_[second]);
+			if constexpr (tracked) {
+				std::swap(versions_[first], versions_[second]);
+			}
 			return err::ok;
 		}
 
 		virtual void DestroyEntity(Entity entity) override {
 			Remove(entity);
 		}
+
+		virtual size_t Size() const override {
+			return memory_layout_.Size();
+		}
+
+		virtual result<Entity> EntityAt(size_t index) const override {
+			return memory_layout_.EntityAt(index);
+		}
+
+		// Drops all components at once, the stored values are left in place
+		virtual void Clear() override {
+			memory_layout_.Clear();
+		}
+
+		virtual err Save(Snapshot& snapshot) const override {
+			if constexpr (!is_snapshot_supported<T>) {
+				return err::not_serializable;
+			}
+			else {
+				memory_layout_.Save(snapshot);
+				const auto size = memory_layout_.Size();
+				if constexpr (is_snapshot_raw<T> && MemoryLayout::packed) {
+					snapshot.Write(components_.data(), size * sizeof(T));
+				}
+				else if constexpr (is_snapshot_raw<T>) {
+					for (size_t position = 0; position < size; position++) {
+						snapshot.Write(components_[indexAt(position)]);
+					}
+				}
+				else {
+					for (size_t position = 0; position < size; position++) {
+						Serializer<T>::Write(snapshot, components_[indexAt(position)]);
+					}
+				}
+				return err::ok;
+			}
+		}
+
+		virtual err Load(SnapshotReader& reader) override {
+			if constexpr (!is_snapshot_supported<T>) {
+				return err::not_serializable;
+			}
+			else {
+				if (const auto error = memory_layout_.Load(reader); error != err::ok) {
+					return error;
+				}
+				const auto size = memory_layout_.Size();
+				auto error = err::ok;
+				if constexpr (is_snapshot_raw<T> && MemoryLayout::packed) {
+					error = reader.Read(components_.data(), size * sizeof(T));
+				}
+				else if constexpr (is_snapshot_raw<T>) {
+					for (size_t position = 0; position < size && error == err::ok; position++) {
+						error = reader.Read(components_[indexAt(position)]);
+					}
+				}
+				else {
+					for (size_t position = 0; position < size && error == err::ok; position++) {
+						error = Serializer<T>::Read(reader, components_[indexAt(position)]);
+					}
+				}
+				if (error != err::ok) {
+					memory_layout_.Clear();
+				}
+				// loaded components count as changed
+				for (size_t position = 0; position < memory_layout_.Size(); position++) {
+					stamp(indexAt(position));
+				}
+				return error;
+			}
+		}
+
+		virtual err Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const override {
+			if constexpr (!is_snapshot_supported<T>) {
+				return err::not_serializable;
+			}
+			else {
+				const auto size = memory_layout_.Validate(reader, type, entities);
+				if (size.error != err::ok) {
+					return size.error;
+				}
+				if constexpr (is_snapshot_raw<T>) {
+					return reader.Skip(size.data * sizeof(T));
+				}
+				else {
+					for (size_t position = 0; position < size.data; position++) {
+						T component{};
+						if (const auto error = Serializer<T>::Read(reader, component); error != err::ok) {
+							return error;
+						}
+					}
+					return err::ok;
+				}
+			}
+		}
+
+		virtual Version VersionOf(Entity entity) const override {
+			if constexpr (tracked) {
+				if (const auto result = memory_layout_.Get(entity); result.error == err::ok) {
+					return versions_[result.data];
+				}
+			}
+			return 0;
+		}
 	};
 	template<typename T>
 	using CompressedComponentArray = ComponentArray<T, ecs::core::Compressor>;
+	template<typename T>
+	using DirectComponentArray = ComponentArray<T, ecs::core::Direct>;
+	template<typename T>
+	using SparseComponentArray = ComponentArray<T, ecs::core::SparseSet>;
+	template<typename T>
+	using PagedComponentArray = ComponentArray<T, ecs::core::PagedSparseSet>;
 }
\ No newline at end of file
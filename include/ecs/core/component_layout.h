@@ -1,10 +1,18 @@
 #pragma once
+#include <array>
+#include <bitset>
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
+#include <memory_resource>
 
 #include <ecs/core/types.h>
+#include <ecs/core/snapshot.h>
 
 namespace ecs::core {
-	// Interface for Component Memory layout logic
+	// Interface for Component Memory layout logic. Packed layouts keep
+	// components in [0, Size()) and move the last one into a removed slot,
+	// the others keep every component at a fixed index.
 	class Layout {
 	public:
 		virtual ~Layout() = default;
@@ -17,19 +25,139 @@ namespace ecs::core {
 		virtual result<size_t> Remove(Entity entity) = 0;
 		// Current size of entities
         virtual size_t Size() const = 0;
+		// Returns entity stored at given array index
+		virtual result<Entity> EntityAt(size_t index) const = 0;
+		// Stored entities in iteration order, Size() long
+		virtual const Entity* Entities() const = 0;
+		// Removes all entities
+		virtual void Clear() = 0;
+		// Exchanges the entities at two array indices, layouts that are not packed return invalid_argument
+		virtual err Swap(size_t first, size_t second) = 0;
+		// Writes the entities in array order
+		virtual void Save(Snapshot& snapshot) const = 0;
+		// Replaces the content with a saved index table
+		virtual err Load(SnapshotReader& reader) = 0;
+		// Reads a saved index table without loading it, every entity has to own type in entities.
+		// Returns the number of saved entities.
+		virtual result<size_t> Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const = 0;
 	};
 
+	// Packed array behind a hash map
 	class Compressor : public Layout {
 	private:
-		std::unordered_map<Entity, size_t> entity_to_index_{};
-		std::unordered_map<size_t, Entity> index_to_entity_{};
+		std::pmr::unordered_map<Entity, size_t> entity_to_index_;
+		// dense, index_to_entity_[index] owns components_[index]
+		std::pmr::vector<Entity> index_to_entity_;
 		size_t size_{ 0 };
 	public:
-		
+		static constexpr bool packed = true;
+
+		explicit Compressor(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+		virtual result<size_t> Add(Entity entity) override;
+		virtual result<size_t> Get(Entity entity) const override;
+		virtual result<size_t> Remove(Entity entity) override;
+        virtual size_t Size() const override;
+		virtual result<Entity> EntityAt(size_t index) const override;
+		virtual const Entity* Entities() const override;
+		virtual void Clear() override;
+		virtual err Swap(size_t first, size_t second) override;
+		virtual void Save(Snapshot& snapshot) const override;
+		virtual err Load(SnapshotReader& reader) override;
+		virtual result<size_t> Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const override;
+	};
+
+	// Component index == entity id, for components most entities own.
+	// Lookups need no indirection, iteration walks a packed entity list.
+	class Direct : public Layout {
+	private:
+		std::bitset<MAX_ENTITY_COUNT> present_{};
+		// position of each entity in entities_
+		std::array<uint32_t, MAX_ENTITY_COUNT> positions_{};
+		std::pmr::vector<Entity> entities_;
+	public:
+		static constexpr bool packed = false;
+
+		explicit Direct(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+		virtual result<size_t> Add(Entity entity) override;
+		virtual result<size_t> Get(Entity entity) const override {
+			if (entity < MAX_ENTITY_COUNT && present_[entity]) {
+				return {entity};
+			}
+			return {err::no_entity};
+		}
+		virtual result<size_t> Remove(Entity entity) override;
+        virtual size_t Size() const override;
+		virtual result<Entity> EntityAt(size_t index) const override;
+		virtual const Entity* Entities() const override;
+		virtual void Clear() override;
+		virtual err Swap(size_t first, size_t second) override;
+		virtual void Save(Snapshot& snapshot) const override;
+		virtual err Load(SnapshotReader& reader) override;
+		virtual result<size_t> Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const override;
+	};
+
+	// Packed array with a flat entity to index table, one array lookup per access
+	class SparseSet : public Layout {
+	private:
+		std::array<uint32_t, MAX_ENTITY_COUNT> sparse_{};
+		std::pmr::vector<Entity> dense_;
+	public:
+		static constexpr bool packed = true;
+
+		explicit SparseSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+		virtual result<size_t> Add(Entity entity) override;
+		virtual result<size_t> Get(Entity entity) const override {
+			// stale sparse entries are caught by the back reference
+			if (entity < MAX_ENTITY_COUNT) {
+				if (const auto index = sparse_[entity]; index < dense_.size() && dense_[index] == entity) {
+					return {index};
+				}
+			}
+			return {err::no_entity};
+		}
+		virtual result<size_t> Remove(Entity entity) override;
+        virtual size_t Size() const override;
+		virtual result<Entity> EntityAt(size_t index) const override;
+		virtual const Entity* Entities() const override;
+		virtual void Clear() override;
+		virtual err Swap(size_t first, size_t second) override;
+		virtual void Save(Snapshot& snapshot) const override;
+		virtual err Load(SnapshotReader& reader) override;
+		virtual result<size_t> Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const override;
+	};
+
+	// Sparse set whose entity to index table is split into pages allocated
+	// on first use, for rare components on entities with scattered ids
+	class PagedSparseSet : public Layout {
+	public:
+		static constexpr size_t PAGE_SIZE = 256;
+	private:
+		// empty pages are not allocated
+		std::pmr::vector<std::pmr::vector<uint32_t>> pages_;
+		std::pmr::vector<Entity> dense_;
+
+		const uint32_t* find(Entity entity) const;
+	public:
+		static constexpr bool packed = true;
+
+		explicit PagedSparseSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
 		virtual result<size_t> Add(Entity entity) override;
 		virtual result<size_t> Get(Entity entity) const override;
 		virtual result<size_t> Remove(Entity entity) override;
         virtual size_t Size() const override;
+		virtual result<Entity> EntityAt(size_t index) const override;
+		virtual const Entity* Entities() const override;
+		virtual void Clear() override;
+		virtual err Swap(size_t first, size_t second) override;
+		virtual void Save(Snapshot& snapshot) const override;
+		virtual err Load(SnapshotReader& reader) override;
+		virtual result<size_t> Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const override;
+		// Number of allocated index pages
+		size_t Pages() const;
 	};
 
 }
\ No newline at end of file
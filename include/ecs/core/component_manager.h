@@ -1,18 +1,69 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <optional>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
+#include <memory_resource>
 #include <typeinfo>
+#include <vector>
 
 #include <ecs/core/types.h>
 #include <ecs/core/component_array.h>
 #include <logging/logging.h>
 
 namespace ecs::core {
+	// Empty types are tags, they live only as a bit in the entity signature
+	template<typename T>
+	static constexpr bool is_tag_v = std::is_empty_v<T>;
+
 	class ComponentManager {
-		using Components = std::unordered_map<size_t, std::shared_ptr<ComponentBase>>;
+		using Components = std::pmr::unordered_map<size_t, std::shared_ptr<ComponentBase>>;
+
+		// Entities owning all components of a group sit at [0, size) of every owned array,
+		// at the same index in each of them
+		struct OwningGroup {
+			Signature owned;
+			std::pmr::vector<ComponentBase*> arrays;
+			size_t size;
+		};
+		static constexpr size_t no_group = MAX_COMPONENTS;
+
+		// Progress of the incremental defragmentation. A job orders one range of one array,
+		// either the group prefix shared by all owned arrays or the array behind it.
+		struct DefragmentJob {
+			bool active;
+			size_t type;
+			bool prefix;
+			size_t cursor;
+			bool swapped;
+			// ranks_ hold the final slots of the range as of this revision
+			bool ranked;
+			size_t revision;
+			// jobs finished in a row without a swap, a full round of them means nothing is left
+			size_t clean;
+		};
 	private:
-		Components components_{};
+		std::pmr::memory_resource* resource_;
+		Components components_;
+		// registered tag types, they have no storage
+		std::pmr::unordered_set<size_t> tags_;
+		// component types holding per frame events
+		std::pmr::vector<size_t> events_;
+		std::pmr::vector<OwningGroup> groups_;
+		// group owning each component type
+		std::array<size_t, MAX_COMPONENTS> group_of_;
+		// current change tick, advanced once per frame
+		Version tick_{ 1 };
+		// bumped by every structural change, invalidates the ranks of the defragmentation
+		size_t revision_{ 0 };
+		DefragmentJob defragment_{};
+		// final slot of every entity in the range of the current job
+		std::array<uint32_t, MAX_ENTITY_COUNT> ranks_{};
 		static inline size_t type_counter_{ 0 };
 
 		template<typename T>
@@ -20,42 +71,254 @@ namespace ecs::core {
 			static size_t type_id = type_counter_++;
 			return type_id;
 		}
+
+		OwningGroup* groupOf(size_t type_key) {
+			return type_key < MAX_COMPONENTS && group_of_[type_key] != no_group ? &groups_[group_of_[type_key]] : nullptr;
+		}
+
+		// Moves entity into the group if it owns all of its components
+		static void groupAdd(OwningGroup& group, Entity entity) {
+			for (const auto* array : group.arrays) {
+				if (array->IndexOf(entity).error != err::ok) {
+					return;
+				}
+			}
+			if (group.arrays.front()->IndexOf(entity).data < group.size) {
+				return;
+			}
+			for (auto* array : group.arrays) {
+				array->Swap(array->IndexOf(entity).data, group.size);
+			}
+			group.size++;
+		}
+
+		// Moves entity behind the group, called before one of its components is removed
+		static void groupRemove(OwningGroup& group, Entity entity) {
+			const auto index = group.arrays.front()->IndexOf(entity);
+			if (index.error != err::ok || index.data >= group.size) {
+				return;
+			}
+			group.size--;
+			for (auto* array : group.arrays) {
+				array->Swap(array->IndexOf(entity).data, group.size);
+			}
+		}
+
+		// Follows a reorder of sorted, the other owned arrays take over its order
+		// and the members are moved back to the front
+		void regroup(size_t type_key, const ComponentBase& sorted) {
+			if (auto* group = groupOf(type_key)) {
+				for (auto* array : group->arrays) {
+					if (array != &sorted) {
+						array->SortAs(sorted);
+					}
+				}
+				groupPack(*group);
+			}
+		}
+
+		// Number of group members at the front of the array of type_key, 0 for unowned types
+		size_t groupSplit(size_t type_key) const {
+			return type_key < MAX_COMPONENTS && group_of_[type_key] != no_group ? groups_[group_of_[type_key]].size : 0;
+		}
+
+		bool leadsGroup(size_t type_key) {
+			const auto* group = groupOf(type_key);
+			return group && group->arrays.front() == components_[type_key].get();
+		}
+
+		// Pairs of neighbours in the array and how many of them are out of entity order.
+		// The group end of owned arrays is not counted, the ranges are ordered separately.
+		void countDescents(size_t type_key, const ComponentBase& array, size_t& descents, size_t& pairs) const {
+			const auto split = groupSplit(type_key);
+			const auto* entities = array.Entities();
+			for (size_t index = 1; index < array.Size(); index++) {
+				if (index == split) {
+					continue;
+				}
+				pairs++;
+				if (entities[index - 1] > entities[index]) {
+					descents++;
+				}
+			}
+		}
+
+		// Moves on to the next range, types in ascending order, a group prefix before
+		// the rest of the leading array. False if no array can be reordered.
+		bool nextJob() {
+			auto& job = defragment_;
+			if (job.active && job.prefix) {
+				job.prefix = false;
+			}
+			else {
+				auto next = components_.end();
+				auto first = components_.end();
+				for (auto component = components_.begin(); component != components_.end(); component++) {
+					if (!component->second->Packed()) {
+						continue;
+					}
+					if (first == components_.end() || component->first < first->first) {
+						first = component;
+					}
+					if (job.active && component->first > job.type && (next == components_.end() || component->first < next->first)) {
+						next = component;
+					}
+				}
+				if (next == components_.end()) {
+					next = first;
+				}
+				if (next == components_.end()) {
+					return false;
+				}
+				job.active = true;
+				job.type = next->first;
+				job.prefix = leadsGroup(job.type);
+			}
+			job.cursor = 0;
+			job.swapped = false;
+			job.ranked = false;
+			return true;
+		}
+
+		// [begin, end) of the current job
+		std::pair<size_t, size_t> jobRange() const {
+			const auto split = groupSplit(defragment_.type);
+			if (defragment_.prefix) {
+				return { 0, split };
+			}
+			return { split, components_.at(defragment_.type)->Size() };
+		}
+
+		// Final slot of every entity in [begin, end) when ordered by entity id
+		void rank(const ComponentBase& array, size_t begin, size_t end) {
+			std::bitset<MAX_ENTITY_COUNT> present;
+			const auto* entities = array.Entities();
+			for (auto index = begin; index < end; index++) {
+				present.set(entities[index]);
+			}
+			auto slot = static_cast<uint32_t>(begin);
+			for (Entity entity = 0; entity < MAX_ENTITY_COUNT; entity++) {
+				if (present[entity]) {
+					ranks_[entity] = slot++;
+				}
+			}
+		}
+
+		static void groupPack(OwningGroup& group) {
+			group.size = 0;
+			const auto* first = group.arrays.front();
+			for (size_t index = 0; index < first->Size(); index++) {
+				groupAdd(group, first->EntityAt(index).data);
+			}
+		}
 	public:
-		ComponentManager() = default;
+		explicit ComponentManager(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			resource_(resource),
+			components_(resource),
+			tags_(resource),
+			events_(resource),
+			groups_(resource) {
+			group_of_.fill(no_group);
+		}
 
 		ComponentManager(const ComponentManager&) = delete;
 		ComponentManager operator=(const ComponentManager&) = delete;
 
-		template<typename T>
+		// Layout picks the index structure of T, see component_layout.h
+		template<typename T, typename Layout = Compressor>
 		err Register() {
 			const auto type_key = getTypeId<T>();
 
-			if (auto component = components_.find(type_key); component == components_.end()) {
-				components_[type_key] = std::make_shared<CompressedComponentArray<T>>() ;
+			if constexpr (is_tag_v<T>) {
+				const auto [it, inserted] = tags_.insert(type_key);
+				return inserted ? err::ok : err::already_registered;
+			}
+			else if (auto component = components_.find(type_key); component == components_.end()) {
+				using Array = ComponentArray<T, Layout>;
+				auto array = std::allocate_shared<Array>(std::pmr::polymorphic_allocator<Array>(resource_), resource_);
+				array->SetTick(tick_);
+				components_[type_key] = array;
 				return err::ok;
 			}
 			return err::already_registered;
 		}
 
+		template<typename T>
+		bool IsRegistered() const {
+			if constexpr (is_tag_v<T>) {
+				return tags_.count(getTypeId<T>()) != 0;
+			}
+			else {
+				return components_.count(getTypeId<T>()) != 0;
+			}
+		}
+
+		// Registers T as event component, all of them are dropped by ClearEvents
+		template<typename T, typename Layout = Compressor>
+		err RegisterEvent() {
+			if (const auto error = Register<T, Layout>(); error != err::ok) {
+				return error;
+			}
+			events_.push_back(getTypeId<T>());
+			return err::ok;
+		}
+
+		// Tags are not stored, the caller checks the signature
 		template<typename T>
 		result<T> Get(Entity entity) {
+			static_assert(!is_tag_v<T>, "Tags have no storage, check the signature instead");
 			const auto type_key = getTypeId<T>();
 
 			if (auto component = components_.find(type_key); component != components_.end()) {
 
-				auto real_component = std::static_pointer_cast<CompressedComponentArray<T>>(component->second);
+				auto real_component = std::static_pointer_cast<ComponentStorage<T>>(component->second);
 				return real_component->Get(entity);
 			}
 			return {err::not_registered};
 		}
 
+		// Only checks the registration of tags, their bit is set by the caller
 		template<typename T>
 		err Add(Entity entity, const T& component) {
 			const auto type_key = getTypeId<T>();
 
-			if (auto component_it = components_.find(type_key); component_it != components_.end()) {
-				auto real_component = std::static_pointer_cast<CompressedComponentArray<T>>(component_it->second);
-				return real_component->Add(entity, component);
+			if constexpr (is_tag_v<T>) {
+				return IsRegistered<T>() ? err::ok : err::not_registered;
+			}
+			else if (auto component_it = components_.find(type_key); component_it != components_.end()) {
+				auto real_component = std::static_pointer_cast<ComponentStorage<T>>(component_it->second);
+				if (const auto error = real_component->Add(entity, component); error != err::ok) {
+					return error;
+				}
+				revision_++;
+				if (auto* group = groupOf(type_key)) {
+					groupAdd(*group, entity);
+				}
+				return err::ok;
+			}
+			return err::not_registered;
+		}
+
+		// Adds copies of component for many entities at once, see ComponentStorage::AddMany
+		template<typename T>
+		err AddMany(const Entity* entities, size_t count, const T& component) {
+			const auto type_key = getTypeId<T>();
+
+			if constexpr (is_tag_v<T>) {
+				return IsRegistered<T>() ? err::ok : err::not_registered;
+			}
+			else if (auto component_it = components_.find(type_key); component_it != components_.end()) {
+				auto real_component = std::static_pointer_cast<ComponentStorage<T>>(component_it->second);
+				if (const auto error = real_component->AddMany(entities, count, component); error != err::ok) {
+					return error;
+				}
+				revision_++;
+				if (auto* group = groupOf(type_key)) {
+					for (size_t index = 0; index < count; index++) {
+						groupAdd(*group, entities[index]);
+					}
+				}
+				return err::ok;
 			}
 			return err::not_registered;
 		}
@@ -64,14 +327,283 @@ namespace ecs::core {
 		err Remove(Entity entity) {
 			const auto type_key = getTypeId<T>();
 
-			if (auto component_it = components_.find(type_key); component_it != components_.end()) {
-				auto real_component = std::static_pointer_cast<CompressedComponentArray<T>>(component_it->second);
+			if constexpr (is_tag_v<T>) {
+				return IsRegistered<T>() ? err::ok : err::not_registered;
+			}
+			else if (auto component_it = components_.find(type_key); component_it != components_.end()) {
+				auto real_component = std::static_pointer_cast<ComponentStorage<T>>(component_it->second);
+				revision_++;
+				if (auto* group = groupOf(type_key)) {
+					groupRemove(*group, entity);
+				}
 				return real_component->Remove(entity);
 			}
 			return err::not_registered;
 		}
 
+		template<typename T>
+		result<T*> GetMutable(Entity entity) {
+			static_assert(!is_tag_v<T>, "Tags have no storage");
+			const auto type_key = getTypeId<T>();
+
+			if (auto component = components_.find(type_key); component != components_.end()) {
+				auto real_component = std::static_pointer_cast<ComponentStorage<T>>(component->second);
+				return real_component->GetMutable(entity);
+			}
+			return {err::not_registered};
+		}
+
+		template<typename T, typename F>
+		err ForEachChanged(Version since, F&& fn) {
+			static_assert(!is_tag_v<T>, "Tags have no storage");
+			const auto type_key = getTypeId<T>();
+
+			if (auto component_it = components_.find(type_key); component_it != components_.end()) {
+				auto real_component = std::static_pointer_cast<ComponentStorage<T>>(component_it->second);
+				real_component->ForEachChanged(since, std::forward<F>(fn));
+				return err::ok;
+			}
+			return err::not_registered;
+		}
+
+		Version Tick() const {
+			return tick_;
+		}
+
+		// Changes with every structural change: components added or removed, entities destroyed, loads
+		size_t Revision() const {
+			return revision_;
+		}
+
+		void AdvanceTick() {
+			tick_++;
+			for (const auto& components : components_) {
+				components.second->SetTick(tick_);
+			}
+		}
+
+		template<typename T, typename F>
+		err ForEach(F&& fn) {
+			static_assert(!is_tag_v<T>, "Tags have no storage, iterate the signatures instead");
+			const auto type_key = getTypeId<T>();
+
+			if (auto component_it = components_.find(type_key); component_it != components_.end()) {
+				auto real_component = std::static_pointer_cast<ComponentStorage<T>>(component_it->second);
+				real_component->ForEach(std::forward<F>(fn));
+				return err::ok;
+			}
+			return err::not_registered;
+		}
+
+		// Owning groups, each component type can be owned by one group. Entities owning all
+		// components of a group are kept at the front of the owned arrays in the same order,
+		// which turns iteration into a linear scan. Owned arrays need a packed layout.
+		template<typename... Owned>
+		err RegisterGroup() {
+			static_assert(sizeof...(Owned) > 1, "A group owns at least two component types");
+			static_assert((!is_tag_v<Owned> && ...), "Tags have no storage to own");
+			const std::array<size_t, sizeof...(Owned)> types{ getTypeId<Owned>()... };
+
+			OwningGroup group{ {}, std::pmr::vector<ComponentBase*>(resource_), 0 };
+			for (const auto type_key : types) {
+				const auto component = components_.find(type_key);
+				if (component == components_.end()) {
+					return err::not_registered;
+				}
+				if (group_of_[type_key] != no_group) {
+					return err::already_registered;
+				}
+				// events are cleared in bulk and Direct arrays can not be reordered
+				if (!component->second->Packed() || std::find(events_.begin(), events_.end(), type_key) != events_.end() || group.owned[type_key]) {
+					return err::invalid_argument;
+				}
+				group.owned.set(type_key);
+				group.arrays.push_back(component->second.get());
+			}
+			for (const auto type_key : types) {
+				group_of_[type_key] = groups_.size();
+			}
+			revision_++;
+			groupPack(group);
+			groups_.push_back(std::move(group));
+			return err::ok;
+		}
+
+		// Number of entities owning all components of the group
+		template<typename... Owned>
+		result<size_t> GroupSize() const {
+			Signature owned;
+			(owned.set(getTypeId<Owned>()), ...);
+			const auto type_key = getTypeId<std::tuple_element_t<0, std::tuple<Owned...>>>();
+			if (type_key >= MAX_COMPONENTS || group_of_[type_key] == no_group || groups_[group_of_[type_key]].owned != owned) {
+				return {err::not_registered};
+			}
+			return {groups_[group_of_[type_key]].size};
+		}
+
+		// Calls fn(entity, Owned&...) for every member of the group registered with the same types,
+		// tracked components are stamped as changed
+		template<typename... Owned, typename F>
+		err ForEachGroup(F&& fn) {
+			const auto size = GroupSize<Owned...>();
+			if (size.error != err::ok) {
+				return size.error;
+			}
+			using First = std::tuple_element_t<0, std::tuple<Owned...>>;
+			const auto* entities = static_cast<ComponentStorage<First>*>(components_[getTypeId<First>()].get())->Entities();
+			const std::tuple<Owned*...> data{
+				static_cast<ComponentStorage<Owned>*>(components_[getTypeId<Owned>()].get())->MutableData(size.data)...
+			};
+			for (size_t index = 0; index < size.data; index++) {
+				fn(entities[index], std::get<Owned*>(data)[index]...);
+			}
+			return err::ok;
+		}
+
+		// Reorders the components of T by compare(const T&, const T&), packed layouts only.
+		// Sorting an owned type reorders the whole group, its members stay at the front.
+		template<typename T, typename Compare>
+		err Sort(Compare&& compare, SortAlgorithm algorithm = SortAlgorithm::full) {
+			static_assert(!is_tag_v<T>, "Tags have no storage");
+			const auto type_key = getTypeId<T>();
+
+			if (auto component_it = components_.find(type_key); component_it != components_.end()) {
+				auto real_component = std::static_pointer_cast<ComponentStorage<T>>(component_it->second);
+				if (const auto error = real_component->Sort(std::forward<Compare>(compare), algorithm); error != err::ok) {
+					return error;
+				}
+				revision_++;
+				regroup(type_key, *real_component);
+				return err::ok;
+			}
+			return err::not_registered;
+		}
+
+		// Orders the components of T like the components of U, entities without a U follow at the end
+		template<typename T, typename U>
+		err SortAs() {
+			static_assert(!is_tag_v<T> && !is_tag_v<U>, "Tags have no storage");
+			const auto type_key = getTypeId<T>();
+			const auto component = components_.find(type_key);
+			const auto other = components_.find(getTypeId<U>());
+			if (component == components_.end() || other == components_.end()) {
+				return err::not_registered;
+			}
+			if (const auto error = component->second->SortAs(*other->second); error != err::ok) {
+				return error;
+			}
+			revision_++;
+			regroup(type_key, *component->second);
+			return err::ok;
+		}
+
+		// Calls fn(entity, component type) for every pending event, then empties all event arrays.
+		// Tag events are handed to clear_tag(component type) instead.
+		template<typename F, typename G>
+		void ClearEvents(F&& fn, G&& clear_tag) {
+			for (const auto type_key : events_) {
+				if (tags_.count(type_key)) {
+					clear_tag(type_key);
+					continue;
+				}
+				const auto& component = components_[type_key];
+				// frames without events leave the defragmentation alone
+				if (component->Size() == 0) {
+					continue;
+				}
+				revision_++;
+
+				for (size_t index = 0; index < component->Size(); index++) {
+					fn(component->EntityAt(index).data, type_key);
+				}
+				component->Clear();
+			}
+		}
+
+		// Saves every component array under its type id. Type ids follow the order of
+		// first use, a world loading the snapshot has to register components in the same order.
+		err Save(Snapshot& snapshot) const {
+			snapshot.Write(components_.size());
+			for (const auto& [type_key, component] : components_) {
+				snapshot.Write(type_key);
+				if (const auto error = component->Save(snapshot); error != err::ok) {
+					return error;
+				}
+			}
+			return err::ok;
+		}
+
+		// Reads the saved components without loading them. Every component has to belong to
+		// a living entity of entities whose signature holds its type.
+		err Validate(SnapshotReader& reader, const SnapshotEntities& entities) const {
+			size_t count = 0;
+			if (const auto error = reader.Read(count); error != err::ok) {
+				return error;
+			}
+			std::bitset<MAX_COMPONENTS> loaded;
+			for (size_t index = 0; index < count; index++) {
+				size_t type_key = 0;
+				if (const auto error = reader.Read(type_key); error != err::ok) {
+					return error;
+				}
+				const auto component = components_.find(type_key);
+				if (component == components_.end()) {
+					return err::not_registered;
+				}
+				if (type_key >= MAX_COMPONENTS || loaded[type_key]) {
+					return err::invalid_argument;
+				}
+				loaded.set(type_key);
+				if (const auto error = component->second->Validate(reader, type_key, entities); error != err::ok) {
+					return error;
+				}
+			}
+			return err::ok;
+		}
+
+		// Replaces all components, arrays missing in the snapshot are left empty.
+		// The snapshot is validated against entities first, on error nothing changes.
+		err Load(SnapshotReader& reader, const SnapshotEntities& entities) {
+			SnapshotReader check = reader;
+			if (const auto error = Validate(check, entities); error != err::ok) {
+				return error;
+			}
+			revision_++;
+			for (const auto& components : components_) {
+				components.second->Clear();
+			}
+			for (auto& group : groups_) {
+				group.size = 0;
+			}
+
+			size_t count = 0;
+			if (const auto error = reader.Read(count); error != err::ok) {
+				return error;
+			}
+			for (size_t loaded = 0; loaded < count; loaded++) {
+				size_t type_key = 0;
+				if (const auto error = reader.Read(type_key); error != err::ok) {
+					return error;
+				}
+				const auto component = components_.find(type_key);
+				if (component == components_.end()) {
+					return err::not_registered;
+				}
+				if (const auto error = component->second->Load(reader); error != err::ok) {
+					return error;
+				}
+			}
+			for (auto& group : groups_) {
+				groupPack(group);
+			}
+			return err::ok;
+		}
+
 		err DestroyEntity(Entity entity) {
+			revision_++;
+			for (auto& group : groups_) {
+				groupRemove(group, entity);
+			}
 			for (const auto& components : components_) {
 				const auto& component = components.second;
 
@@ -80,8 +612,91 @@ namespace ecs::core {
 			return err::ok;
 		}
 
+		// Moves components towards ascending entity order, undoing the shuffle left by swap
+		// removal. Works through the packed arrays one after another and resumes where the
+		// last call stopped, a step checks or swaps one slot. Owned arrays are ordered in
+		// front of and behind the group end, the members move in all owned arrays at once.
+		// Reverts Sort. Returns the steps taken, fewer than budget once everything is ordered.
+		size_t Defragment(size_t budget) {
+			const auto jobs = components_.size() + groups_.size();
+			size_t steps = 0;
+			while (steps < budget) {
+				auto& job = defragment_;
+				if (!job.active && !nextJob()) {
+					return steps;
+				}
+				auto* array = components_[job.type].get();
+				const auto [begin, end] = jobRange();
+				if (job.revision != revision_) {
+					job.clean = 0;
+				}
+				if (!job.ranked || job.revision != revision_) {
+					rank(*array, begin, end);
+					job.cursor = std::clamp(job.cursor, begin, end);
+					job.ranked = true;
+					job.revision = revision_;
+				}
+				if (job.cursor >= end) {
+					job.clean = job.swapped ? 0 : job.clean + 1;
+					if (job.clean > jobs) {
+						return steps;
+					}
+					nextJob();
+					continue;
+				}
+
+				// every swap puts one component into its final slot
+				const auto target = ranks_[array->Entities()[job.cursor]];
+				if (target == job.cursor) {
+					job.cursor++;
+				}
+				else if (job.prefix) {
+					for (auto* owned : groupOf(job.type)->arrays) {
+						owned->Swap(job.cursor, target);
+					}
+					job.swapped = true;
+				}
+				else {
+					array->Swap(job.cursor, target);
+					job.swapped = true;
+				}
+				steps++;
+			}
+			return steps;
+		}
+
+		// Share of neighbouring components out of entity order over all packed arrays,
+		// 0 for ordered arrays, about 0.5 for randomly shuffled ones
+		float Fragmentation() const {
+			size_t descents = 0;
+			size_t pairs = 0;
+			for (const auto& [type_key, component] : components_) {
+				if (component->Packed()) {
+					countDescents(type_key, *component, descents, pairs);
+				}
+			}
+			return pairs ? static_cast<float>(descents) / static_cast<float>(pairs) : 0.0f;
+		}
+
+		template<typename T>
+		result<float> Fragmentation() const {
+			static_assert(!is_tag_v<T>, "Tags have no storage");
+			const auto type_key = getTypeId<T>();
+			const auto component = components_.find(type_key);
+			if (component == components_.end()) {
+				return {err::not_registered};
+			}
+			if (!component->second->Packed()) {
+				return {err::invalid_argument};
+			}
+			size_t descents = 0;
+			size_t pairs = 0;
+			countDescents(type_key, *component->second, descents, pairs);
+			return {pairs ? static_cast<float>(descents) / static_cast<float>(pairs) : 0.0f};
+		}
+
 		template<typename T>
-		ComponentType GetComponentType() const {
+		static ComponentType GetComponentType() {
 			return getTypeId<T>();
 		}
 
@@ -1,9 +1,18 @@
 #pragma once
+#include <fstream>
 #include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
 
+#include <ecs/core/memory.h>
+#include <ecs/core/prefab.h>
+#include <ecs/core/resources.h>
+#include <ecs/core/snapshot.h>
 #include <ecs/core/entity_manager.h>
 #include <ecs/core/component_manager.h>
 #include <ecs/core/system_manager.h>
+#include <utils/mapped_file.h>
 
 namespace ecs::core {
     template<typename Events>
@@ -13,18 +22,76 @@ namespace ecs::core {
     using ComponentManagerPtr = std::shared_ptr<ComponentManager>;
     using SystemManagerPtr = std::shared_ptr<SystemManager<Events>>;
     private:
+        // declared first, the managers allocate from it until they are destroyed
+        std::unique_ptr<WorldMemory> memory_{};
         EntityManagerPtr entity_manager_{};
         ComponentManagerPtr component_manager_{};
         SystemManagerPtr system_manager_{};
+        ResourceTable resources_;
+        // defragmentation steps run at the end of every Update
+        size_t defragment_budget_{ 0 };
+        // saved entities of the snapshot being loaded, created by the first restore
+        std::unique_ptr<SnapshotEntities> restore_entities_{};
+
+        template<typename T, typename... Args>
+        std::shared_ptr<T> makeManager(Subsystem subsystem, Args&&... args) {
+            auto* resource = memory_->Resource(subsystem);
+            return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource), std::forward<Args>(args)..., resource);
+        }
+
+        // Loads entities and components behind the header, the systems are not touched.
+        // The whole snapshot is checked before anything changes, a corrupt one leaves the world as it is.
+        err load(SnapshotReader& reader) {
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            if (reader.Read(magic) != err::ok || reader.Read(version) != err::ok ||
+                magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+                return err::invalid_argument;
+            }
+            if (!restore_entities_) {
+                restore_entities_ = std::make_unique<SnapshotEntities>();
+            }
+            // the components follow the entities, they are checked against them and loaded first
+            SnapshotReader components = reader;
+            if (const auto error = EntityManager::Validate(components, restore_entities_.get()); error != err::ok) {
+                return error;
+            }
+            if (const auto error = component_manager_->Load(components, *restore_entities_); error != err::ok) {
+                return error;
+            }
+            return entity_manager_->Load(reader);
+        }
+
+        void rebuildSystems() {
+            system_manager_->RebuildEntities([this](auto&& add) {
+                for (Entity entity = 0; entity < MAX_ENTITY_COUNT; entity++) {
+                    if (const auto signature = entity_manager_->GetSignature(entity); signature.error == err::ok) {
+                        add(entity, signature.data);
+                    }
+                }
+            });
+        }
     public:
+        // Creates all managers on the memory pools of this instance
+        explicit EntityComponentSystem(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+        memory_(std::make_unique<WorldMemory>(upstream)),
+        entity_manager_(makeManager<EntityManager>(Subsystem::entities, MAX_ENTITY_COUNT)),
+        component_manager_(makeManager<ComponentManager>(Subsystem::components)),
+        system_manager_(makeManager<SystemManager<Events>>(Subsystem::systems)),
+        resources_(memory_->Resource(Subsystem::components)) {
+
+        }
+
         EntityComponentSystem(
-            EntityManagerPtr entity_manager = std::make_shared<EntityManager>(),
-            ComponentManagerPtr component_manager = std::make_shared<ComponentManager>(),
-            SystemManagerPtr system_manager = std::make_shared<SystemManager<Events>>()
+            EntityManagerPtr entity_manager,
+            ComponentManagerPtr component_manager,
+            SystemManagerPtr system_manager
         ) :
+        memory_(std::make_unique<WorldMemory>()),
         entity_manager_(entity_manager),
         component_manager_(component_manager),
-        system_manager_(system_manager) {
+        system_manager_(system_manager),
+        resources_(memory_->Resource(Subsystem::components)) {
 
         }
 
@@ -32,16 +99,42 @@ namespace ecs::core {
             return entity_manager_->CreateEntity();
         }
 
+        result<Signature> GetSignature(Entity entity) const {
+            return entity_manager_->GetSignature(entity);
+        }
+
         void DestroyEntity(const Entity entity) {
             entity_manager_->DestroyEntity(entity);
             component_manager_->DestroyEntity(entity);
             system_manager_->DestroyEntity(entity);
         }
 
+        // Creates count copies of prefab and appends them to created. Ids are allocated at once,
+        // every component array is filled in one call and the systems are matched once.
+        // Nothing is created on failure.
+        err Instantiate(const Prefab& prefab, size_t count, std::vector<Entity>& created) {
+            const auto first = created.size();
+            if (const auto error = entity_manager_->CreateEntities(count, prefab.GetSignature(), created); error != err::ok) {
+                return error;
+            }
+            const auto* entities = created.data() + first;
+            if (const auto error = prefab.Apply(*component_manager_, entities, count); error != err::ok) {
+                for (size_t index = 0; index < count; index++) {
+                    DestroyEntity(entities[index]);
+                }
+                created.resize(first);
+                return error;
+            }
+            system_manager_->AddEntities(entities, count, prefab.GetSignature());
+            return err::ok;
+        }
+
         // Component Methods
-        template<typename T>
+        // Compressor suits most components. Direct is fastest for components nearly
+        // every entity has, SparseSet and PagedSparseSet for rare ones.
+        template<typename T, typename Layout = Compressor>
         err RegisterComponent() {
-            return component_manager_->Register<T>();
+            return component_manager_->template Register<T, Layout>();
         }
 
         template<typename T>
@@ -68,6 +161,11 @@ namespace ecs::core {
             if(const auto error = component_manager_->Remove<T>(entity); error != err::ok) {
                 return error;
             }
+            if constexpr (is_tag_v<T>) {
+                if(!HasComponent<T>(entity)) {
+                    return err::no_entity;
+                }
+            }
 
             auto result = entity_manager_->GetSignature(entity);
             auto& signature = result.data;
@@ -81,9 +179,31 @@ namespace ecs::core {
             return err::ok;
         }
 
+        // Tags are returned as a default constructed value
         template<typename T>
         result<T> GetComponent(Entity entity) {
-            return component_manager_->Get<T>(entity);
+            if constexpr (is_tag_v<T>) {
+                if(!component_manager_->IsRegistered<T>()) {
+                    return {err::not_registered};
+                }
+                return HasComponent<T>(entity) ? result<T>{T{}} : result<T>{err::no_entity};
+            }
+            else {
+                return component_manager_->Get<T>(entity);
+            }
+        }
+
+        // Checks the signature bit only, works for tags and stored components
+        template<typename T>
+        bool HasComponent(Entity entity) const {
+            const auto signature = entity_manager_->GetSignature(entity);
+            return signature.error == err::ok && signature.data.test(component_manager_->GetComponentType<T>());
+        }
+
+        // Calls fn(entity) for every entity owning all components of signature
+        template<typename F>
+        void ForEachEntity(Signature signature, F&& fn) const {
+            entity_manager_->ForEachMatching(signature, std::forward<F>(fn));
         }
 
         template<typename T>
@@ -91,14 +211,264 @@ namespace ecs::core {
             return component_manager_->GetComponentType<T>();
         }
 
+        // Calls fn(entity, component) for every entity owning a T
+        template<typename T, typename F>
+        err ForEachComponent(F&& fn) {
+            if constexpr (is_tag_v<T>) {
+                if(!component_manager_->IsRegistered<T>()) {
+                    return err::not_registered;
+                }
+                Signature signature;
+                signature.set(component_manager_->GetComponentType<T>());
+                entity_manager_->ForEachMatching(signature, [&fn](Entity entity) {
+                    T tag{};
+                    fn(entity, tag);
+                });
+                return err::ok;
+            }
+            else {
+                return component_manager_->ForEach<T>(std::forward<F>(fn));
+            }
+        }
+
+        // Owning groups keep the entities owning all of Owned packed at the front of the
+        // owned arrays, see ComponentManager::RegisterGroup. Register the components first.
+        template<typename... Owned>
+        err RegisterGroup() {
+            return component_manager_->template RegisterGroup<Owned...>();
+        }
+
+        // Calls fn(entity, Owned&...) for every member of the group, a linear scan of the owned arrays
+        template<typename... Owned, typename F>
+        err ForEachGroup(F&& fn) {
+            return component_manager_->template ForEachGroup<Owned...>(std::forward<F>(fn));
+        }
+
+        template<typename... Owned>
+        result<size_t> GroupSize() const {
+            return component_manager_->template GroupSize<Owned...>();
+        }
+
+        // Sorts the components of T by compare(const T&, const T&), iteration follows the new order.
+        // SortAlgorithm::insertion is cheap for arrays that stay nearly sorted between frames.
+        template<typename T, typename Compare>
+        err Sort(Compare&& compare, SortAlgorithm algorithm = SortAlgorithm::full) {
+            return component_manager_->template Sort<T>(std::forward<Compare>(compare), algorithm);
+        }
+
+        // Orders the components of T like the components of U
+        template<typename T, typename U>
+        err SortAs() {
+            return component_manager_->template SortAs<T, U>();
+        }
+
+        // Moves components back towards entity order, at most budget slots per call.
+        // Iterating several components of the same entities then walks memory forward.
+        // See ComponentManager::Defragment, it reverts Sort.
+        size_t Defragment(size_t budget) {
+            return component_manager_->Defragment(budget);
+        }
+
+        // Runs Defragment(budget) at the end of every Update, 0 turns it off
+        void SetDefragmentBudget(size_t budget) {
+            defragment_budget_ = budget;
+        }
+
+        // Share of neighbouring components out of entity order, 0 when fully ordered
+        float Fragmentation() const {
+            return component_manager_->Fragmentation();
+        }
+
+        template<typename T>
+        result<float> Fragmentation() const {
+            return component_manager_->template Fragmentation<T>();
+        }
+
+        // Change tracking, see TrackChanges
+
+        // Pointer to the stored component, marks it as changed
+        template<typename T>
+        result<T*> GetMutableComponent(Entity entity) {
+            return component_manager_->GetMutable<T>(entity);
+        }
+
+        // Calls fn(entity, const component&) for components changed at or after tick since
+        template<typename T, typename F>
+        err ForEachChanged(Version since, F&& fn) {
+            return component_manager_->ForEachChanged<T>(since, std::forward<F>(fn));
+        }
+
+        // Current change tick, advanced at the end of every Update
+        Version Tick() const {
+            return component_manager_->Tick();
+        }
+
+        // Changes whenever components are added or removed or entities destroyed,
+        // caches over component membership can skip their refresh while it stays the same
+        size_t StructureRevision() const {
+            return component_manager_->Revision();
+        }
+
+        // Resource Methods
+
+        // World level singletons like input state or configuration, not part of snapshots
+        template<typename T>
+        err SetResource(T resource) {
+            return resources_.Set(std::move(resource));
+        }
+
+        // Pointer to the resource, nullptr if it is not set. Stays valid until the resource is removed.
+        template<typename T>
+        T* Resource() const {
+            return resources_.Get<T>();
+        }
+
+        template<typename T>
+        err RemoveResource() {
+            return resources_.Remove<T>();
+        }
+
+        // Event Methods
+
+        // Events are components that only live until the next ClearEvents call
+        template<typename T, typename Layout = Compressor>
+        err RegisterEvent() {
+            return component_manager_->template RegisterEvent<T, Layout>();
+        }
+
+        template<typename T>
+        err EmitEvent(Entity entity, const T& evnt) {
+            const auto result = entity_manager_->GetSignature(entity);
+            if(result.error != err::ok) {
+                return result.error;
+            }
+            if(result.data.test(component_manager_->GetComponentType<T>())) {
+                return err::already_registered;
+            }
+            return AddComponent(entity, evnt);
+        }
+
+        // Drops all pending events in bulk, usually called at frame end
+        void ClearEvents() {
+            const auto clear = [this](Entity entity, ComponentType type) {
+                auto result = entity_manager_->GetSignature(entity);
+                auto& signature = result.data;
+                signature.set(type, false);
+
+                if(entity_manager_->SetSignature(entity, signature) == err::ok) {
+                    system_manager_->SetEntitySignature(entity, signature);
+                }
+            };
+            component_manager_->ClearEvents(clear, [this, &clear](ComponentType type) {
+                Signature signature;
+                signature.set(type);
+                entity_manager_->ForEachMatching(signature, [&clear, type](Entity entity) {
+                    clear(entity, type);
+                });
+            });
+        }
+
+        // Frame Methods
+
+        // Runs all systems, flushes queued events and plays back deferred changes.
+        // Event components are dropped at the end of the frame.
+        void Update(time_ms delta_time) {
+            system_manager_->Defer([this]() { ClearEvents(); });
+            system_manager_->Update(delta_time);
+            if (defragment_budget_) {
+                component_manager_->Defragment(defragment_budget_);
+            }
+            component_manager_->AdvanceTick();
+            memory_->Frame().Reset();
+        }
+
+        // Scratch memory for the current frame, released at the end of Update
+        std::pmr::memory_resource* FrameAllocator() {
+            return &memory_->Frame();
+        }
+
+        // Allocations of the managers of one subsystem
+        const utils::memory::MemoryStats& MemoryStats(Subsystem subsystem) {
+            return memory_->Stats(subsystem);
+        }
+
+        void Post(Events evnt, const ecs::event::Message& message = {}) {
+            system_manager_->Post(evnt, message);
+        }
+
+        // Records a structural change (create/destroy, add/remove) for the end of the frame
+        void Defer(std::function<void()> command) {
+            system_manager_->Defer(std::move(command));
+        }
+
+        ecs::event::EventBus<Events>& GetEventBus() {
+            return system_manager_->GetEventBus();
+        }
+
+        std::chrono::nanoseconds PhaseTime(Phase phase) const {
+            return system_manager_->PhaseTime(phase);
+        }
+
+        template<typename T>
+        result<SystemStats> GetSystemStats() const {
+            return system_manager_->template GetStats<T>();
+        }
+
+        void SetStatsLogInterval(size_t interval) {
+            system_manager_->SetStatsLogInterval(interval);
+        }
+
+        // Snapshot Methods
+
+        // Saves entities and all components, the snapshot is cleared first.
+        // Systems, queued events and deferred commands are not part of it.
+        err Save(Snapshot& snapshot) const {
+            snapshot.Clear();
+            snapshot.Write(SNAPSHOT_MAGIC);
+            snapshot.Write(SNAPSHOT_VERSION);
+            entity_manager_->Save(snapshot);
+            return component_manager_->Save(snapshot);
+        }
+
+        // Replaces all entities and components and refills the systems.
+        // Components have to be registered in the same order as in the saved world.
+        // On error the world is left as it was before the call.
+        err Restore(SnapshotReader reader) {
+            if (const auto error = load(reader); error != err::ok) {
+                return error;
+            }
+            rebuildSystems();
+            return err::ok;
+        }
+
+        // World files are snapshots on disk, written by SaveWorld
+        err SaveWorld(const std::string& filename) const {
+            Snapshot snapshot;
+            if (const auto error = Save(snapshot); error != err::ok) {
+                return error;
+            }
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(snapshot.Data()), static_cast<std::streamsize>(snapshot.Size()));
+            return file ? err::ok : err::invalid_argument;
+        }
+
+        // Maps the world file and copies it into the arrays in one pass
+        err LoadWorld(const std::string& filename) {
+            const utils::MappedFile file(filename);
+            if (!file.IsOpen()) {
+                return err::invalid_argument;
+            }
+            return Restore({file.Data(), file.Size()});
+        }
+
         // System Methods
 
         template<typename T>
-        err RegisterSystem(std::shared_ptr<ecs::core::System> system) {
-            if(const auto error = system_manager_->Register<T>(system); error != err::ok) {
+        err RegisterSystem(std::shared_ptr<T> system) {
+            if(const auto error = system_manager_->template Register<T>(system); error != err::ok) {
                 return error;
             }
-            if(const auto error = system_manager_->SetSystemSignature<T>(ecs::core::Signature{}); error != err::ok) {
+            if(const auto error = system_manager_->template SetSystemSignature<T>(ecs::core::Signature{}); error != err::ok) {
                 return error;
             }
             return err::ok;
@@ -106,10 +476,10 @@ namespace ecs::core {
 
         template<typename T>
         err RegisterSystem() {
-            if(const auto error = system_manager_->Register<T>(); error != err::ok) {
+            if(const auto error = system_manager_->template Register<T>(); error != err::ok) {
                 return error;
             }
-            if(const auto error = system_manager_->SetSystemSignature<T>(ecs::core::Signature{}); error != err::ok) {
+            if(const auto error = system_manager_->template SetSystemSignature<T>(ecs::core::Signature{}); error != err::ok) {
                 return error;
             }
             return err::ok;
@@ -117,7 +487,14 @@ namespace ecs::core {
 
         template<typename T>
         err SetSystemSignature(Signature signature) {
-            return system_manager_->SetSystemSignature<T>(signature);
+            return system_manager_->template SetSystemSignature<T>(signature);
+        }
+
+        // Whether two systems access a resource in a way that prevents running them concurrently,
+        // see System::ReadsResources and System::WritesResources
+        template<typename A, typename B>
+        result<bool> SystemsConflict() const {
+            return system_manager_->template Conflicts<A, B>();
         }
 
         template<typename T>
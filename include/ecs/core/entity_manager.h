@@ -1,18 +1,21 @@
 #pragma once
-#include <queue>
-#include <unordered_set>
+#include <deque>
+#include <bitset>
 #include <array>
+#include <memory_resource>
+#include <vector>
 
 #include <ecs/core/types.h>
+#include <ecs/core/snapshot.h>
 
 namespace ecs::core {
 
     class EntityManager {
     private:
-        // unused entities
-        std::queue<Entity> available_entities_;
+        // unused entities, reused in FIFO order
+        std::pmr::deque<Entity> available_entities_;
         // remember created entities
-        std::unordered_set<Entity> living_entities_;
+        std::bitset<MAX_ENTITY_COUNT> living_entities_;
         // array of signatures
         std::array<Signature, MAX_ENTITY_COUNT> signatures_;
         // total entities
@@ -20,15 +23,34 @@ namespace ecs::core {
 
         err entityExist(Entity entity) const;
     public:
-        EntityManager(size_t max_entity_count = MAX_ENTITY_COUNT);
+        EntityManager(size_t max_entity_count = MAX_ENTITY_COUNT, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
         EntityManager(const EntityManager&) = delete;
         EntityManager& operator=(const EntityManager&) = delete;
 
         result<Entity> CreateEntity();
+        // Creates count entities with the given signature and appends them to entities,
+        // nothing is created if fewer than count ids are available
+        err CreateEntities(size_t count, Signature signature, std::vector<Entity>& entities);
         err DestroyEntity(Entity entity);
         err SetSignature(Entity entity, Signature signature);
         result<Signature> GetSignature(Entity entity) const;
         size_t Count() const;
         bool Empty() const;
+
+        // Calls fn(entity) for every living entity whose signature contains all bits of mask
+        template<typename F>
+        void ForEachMatching(Signature mask, F&& fn) const {
+            for (Entity entity = 0; entity < MAX_ENTITY_COUNT; entity++) {
+                if (living_entities_[entity] && (signatures_[entity] & mask) == mask) {
+                    fn(entity);
+                }
+            }
+        }
+
+        // Writes living entities, the reuse order and all signatures
+        void Save(Snapshot& snapshot) const;
+        // Reads and checks saved entities without loading them, optionally keeping them for the component checks
+        static err Validate(SnapshotReader& reader, SnapshotEntities* entities = nullptr);
+        err Load(SnapshotReader& reader);
     };
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include <memory_resource>
+
+#include <utils/memory.h>
+
+namespace ecs::core {
+    enum class Subsystem {
+        entities,
+        components,
+        systems,
+    };
+
+    // Memory of one EntityComponentSystem. All managers allocate from shared
+    // fixed size pools, counted per subsystem. The frame arena is reset after every Update.
+    class WorldMemory {
+    private:
+        std::pmr::unsynchronized_pool_resource pools_;
+        utils::memory::CountingResource entities_;
+        utils::memory::CountingResource components_;
+        utils::memory::CountingResource systems_;
+        utils::memory::FrameArena frame_;
+    public:
+        explicit WorldMemory(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+        pools_(upstream),
+        entities_(&pools_),
+        components_(&pools_),
+        systems_(&pools_),
+        frame_(64 * 1024, upstream) {
+
+        }
+
+        WorldMemory(const WorldMemory&) = delete;
+        WorldMemory& operator=(const WorldMemory&) = delete;
+
+        utils::memory::CountingResource* Resource(Subsystem subsystem) {
+            switch (subsystem) {
+            case Subsystem::entities:
+                return &entities_;
+            case Subsystem::components:
+                return &components_;
+            default:
+                return &systems_;
+            }
+        }
+
+        const utils::memory::MemoryStats& Stats(Subsystem subsystem) {
+            return Resource(subsystem)->Stats();
+        }
+
+        utils::memory::FrameArena& Frame() {
+            return frame_;
+        }
+    };
+}
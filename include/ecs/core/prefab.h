@@ -0,0 +1,60 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include <ecs/core/types.h>
+#include <ecs/core/component_manager.h>
+
+namespace ecs::core {
+	// Signature plus component values, instantiated in bulk by EntityComponentSystem::Instantiate
+	class Prefab {
+		using AddMany = err (*)(ComponentManager&, const Entity*, size_t, const void*);
+
+		struct Component {
+			ComponentType type;
+			std::shared_ptr<const void> value;
+			AddMany add;
+		};
+	private:
+		Signature signature_{};
+		std::vector<Component> components_{};
+
+		template<typename T>
+		static err addMany(ComponentManager& manager, const Entity* entities, size_t count, const void* value) {
+			return manager.AddMany(entities, count, *static_cast<const T*>(value));
+		}
+	public:
+		// Sets the value of component T, replaces an earlier value of the same type
+		template<typename T>
+		Prefab& Set(const T& component) {
+			const auto type = ComponentManager::GetComponentType<T>();
+			Component entry{ type, std::make_shared<const T>(component), &addMany<T> };
+			if (signature_.test(type)) {
+				for (auto& existing : components_) {
+					if (existing.type == type) {
+						existing = std::move(entry);
+					}
+				}
+			}
+			else {
+				signature_.set(type);
+				components_.push_back(std::move(entry));
+			}
+			return *this;
+		}
+
+		Signature GetSignature() const {
+			return signature_;
+		}
+
+		// Adds all components to the given entities, stops at the first failing type
+		err Apply(ComponentManager& manager, const Entity* entities, size_t count) const {
+			for (const auto& component : components_) {
+				if (const auto error = component.add(manager, entities, count, component.value.get()); error != err::ok) {
+					return error;
+				}
+			}
+			return err::ok;
+		}
+	};
+}
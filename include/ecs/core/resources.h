@@ -0,0 +1,94 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <memory_resource>
+#include <utility>
+
+#include <ecs/core/types.h>
+
+namespace ecs::core {
+	static constexpr size_t MAX_RESOURCES = 64;
+	using ResourceType = size_t;
+	using ResourceMask = std::bitset<MAX_RESOURCES>;
+
+	// World level singletons indexed by type, a lookup is a single pointer load.
+	// Values are allocated once and keep their address until removed.
+	class ResourceTable {
+		using Destroy = void (*)(std::pmr::memory_resource*, void*);
+	private:
+		std::pmr::memory_resource* resource_;
+		std::array<void*, MAX_RESOURCES> data_{};
+		std::array<Destroy, MAX_RESOURCES> destroy_{};
+
+		static inline ResourceType type_counter_{ 0 };
+
+		template<typename T>
+		static void destroy(std::pmr::memory_resource* resource, void* data) {
+			auto* value = static_cast<T*>(data);
+			value->~T();
+			std::pmr::polymorphic_allocator<T>(resource).deallocate(value, 1);
+		}
+	public:
+		explicit ResourceTable(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			resource_(resource) {}
+
+		ResourceTable(const ResourceTable&) = delete;
+		ResourceTable& operator=(const ResourceTable&) = delete;
+
+		~ResourceTable() {
+			Clear();
+		}
+
+		template<typename T>
+		static ResourceType GetType() {
+			static ResourceType type = type_counter_++;
+			return type;
+		}
+
+		// Stores value, an existing resource is assigned in place
+		template<typename T>
+		err Set(T value) {
+			const auto type = GetType<T>();
+			if (type >= MAX_RESOURCES) {
+				return err::invalid_argument;
+			}
+			if (data_[type]) {
+				*static_cast<T*>(data_[type]) = std::move(value);
+				return err::ok;
+			}
+			std::pmr::polymorphic_allocator<T> allocator(resource_);
+			T* data = allocator.allocate(1);
+			allocator.construct(data, std::move(value));
+			data_[type] = data;
+			destroy_[type] = &destroy<T>;
+			return err::ok;
+		}
+
+		// nullptr if the resource is not set
+		template<typename T>
+		T* Get() const {
+			const auto type = GetType<T>();
+			return type < MAX_RESOURCES ? static_cast<T*>(data_[type]) : nullptr;
+		}
+
+		template<typename T>
+		err Remove() {
+			const auto type = GetType<T>();
+			if (type >= MAX_RESOURCES || !data_[type]) {
+				return err::not_registered;
+			}
+			destroy_[type](resource_, data_[type]);
+			data_[type] = nullptr;
+			return err::ok;
+		}
+
+		void Clear() {
+			for (ResourceType type = 0; type < MAX_RESOURCES; type++) {
+				if (data_[type]) {
+					destroy_[type](resource_, data_[type]);
+					data_[type] = nullptr;
+				}
+			}
+		}
+	};
+}
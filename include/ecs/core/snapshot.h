@@ -0,0 +1,120 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <ecs/core/types.h>
+
+namespace ecs::core {
+	static constexpr uint32_t SNAPSHOT_MAGIC = 0x53434553; // "SECS"
+	static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+	// Growing byte buffer a world is saved into. Clear keeps the capacity,
+	// so taking a snapshot every frame does not allocate once warmed up.
+	class Snapshot {
+	private:
+		std::vector<std::byte> data_{};
+	public:
+		void Write(const void* data, size_t size) {
+			if (size == 0) {
+				return;
+			}
+			const auto offset = data_.size();
+			data_.resize(offset + size);
+			std::memcpy(data_.data() + offset, data, size);
+		}
+
+		template<typename T>
+		void Write(const T& value) {
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values are written as raw bytes");
+			Write(&value, sizeof(T));
+		}
+
+		void Reserve(size_t size) {
+			data_.reserve(size);
+		}
+
+		void Clear() {
+			data_.clear();
+		}
+
+		const std::byte* Data() const {
+			return data_.data();
+		}
+
+		size_t Size() const {
+			return data_.size();
+		}
+	};
+
+	// Reads a snapshot from memory it does not own
+	class SnapshotReader {
+	private:
+		const std::byte* data_;
+		size_t size_;
+		size_t offset_{ 0 };
+	public:
+		SnapshotReader(const std::byte* data, size_t size) : data_(data), size_(size) {}
+		SnapshotReader(const Snapshot& snapshot) : data_(snapshot.Data()), size_(snapshot.Size()) {}
+
+		err Read(void* data, size_t size) {
+			if (size > size_ - offset_) {
+				return err::invalid_argument;
+			}
+			if (size == 0) {
+				return err::ok;
+			}
+			std::memcpy(data, data_ + offset_, size);
+			offset_ += size;
+			return err::ok;
+		}
+
+		template<typename T>
+		err Read(T& value) {
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values are read as raw bytes");
+			return Read(&value, sizeof(T));
+		}
+
+		err Skip(size_t size) {
+			if (size > size_ - offset_) {
+				return err::invalid_argument;
+			}
+			offset_ += size;
+			return err::ok;
+		}
+
+		size_t Remaining() const {
+			return size_ - offset_;
+		}
+	};
+
+	// Entities of a saved world, the components of a snapshot are checked against them
+	struct SnapshotEntities {
+		std::bitset<MAX_ENTITY_COUNT> living{};
+		std::array<Signature, MAX_ENTITY_COUNT> signatures{};
+
+		// Whether the saved entity is alive and its signature holds type
+		bool Owns(Entity entity, ComponentType type) const {
+			return entity < MAX_ENTITY_COUNT && type < MAX_COMPONENTS && living[entity] && signatures[entity][type];
+		}
+	};
+
+	// Opt-in serialization for components that are not trivially copyable, or
+	// that should not be copied as raw bytes. Specialize with enabled = true and
+	//   static void Write(Snapshot&, const T&);
+	//   static err Read(SnapshotReader&, T&);
+	template<typename T>
+	struct Serializer {
+		static constexpr bool enabled = false;
+	};
+
+	template<typename T>
+	static constexpr bool is_snapshot_raw = std::is_trivially_copyable_v<T> && !Serializer<T>::enabled;
+
+	template<typename T>
+	static constexpr bool is_snapshot_supported = is_snapshot_raw<T> || Serializer<T>::enabled;
+}
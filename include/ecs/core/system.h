@@ -1,16 +1,54 @@
 #pragma once
 #include <unordered_set>
+#include <memory_resource>
+#include <new>
 
 #include <ecs/core/types.h>
+#include <ecs/core/resources.h>
 
 namespace ecs::core {
 	using time_ms = uint32_t;
 	class System {
 	private:
-		std::unordered_set<Entity> entities_{};
+		std::pmr::unordered_set<Entity> entities_{};
+		ResourceMask reads_{};
+		ResourceMask writes_{};
+		err resources_{ err::ok };
+
+		template<typename T>
+		void access(ResourceMask& mask) {
+			const auto type = ResourceTable::GetType<T>();
+			if (type >= MAX_RESOURCES) {
+				resources_ = err::invalid_argument;
+				return;
+			}
+			mask.set(type);
+		}
+	protected:
+		// Declares the resources update accesses, usually called from the constructor. More than
+		// MAX_RESOURCES resource types give invalid_argument, kept for SystemManager to refuse the system.
+		template<typename... T>
+		err ReadsResources() {
+			(access<T>(reads_), ...);
+			return resources_;
+		}
+
+		template<typename... T>
+		err WritesResources() {
+			(access<T>(writes_), ...);
+			return resources_;
+		}
 	public:
 		virtual ~System() = default;
 
+		// Moves the entity set to the given resource, called by SystemManager for the systems it creates
+		void UseMemoryResource(std::pmr::memory_resource* resource) {
+			std::pmr::unordered_set<Entity> entities(entities_.begin(), entities_.end(), entities_.bucket_count(), resource);
+			// pmr containers never change their resource, so the set is rebuilt in place
+			entities_.~unordered_set();
+			new (&entities_) std::pmr::unordered_set<Entity>(std::move(entities));
+		}
+
 		err Add(Entity entity) {
 			const auto [it, inserted] = entities_.insert(entity);
 			if(inserted) return err::ok;
@@ -23,6 +61,34 @@ namespace ecs::core {
 			return err::not_registered;
 		}
 
+		void Clear() {
+			entities_.clear();
+		}
+
+		size_t Size() const {
+			return entities_.size();
+		}
+
+		const ResourceMask& ResourceReads() const {
+			return reads_;
+		}
+
+		const ResourceMask& ResourceWrites() const {
+			return writes_;
+		}
+
+		// Error of the resource declarations, ok when every declared resource fits the masks
+		err ResourceError() const {
+			return resources_;
+		}
+
+		// Systems conflict if one of them writes a resource the other one accesses
+		bool ConflictsWith(const System& other) const {
+			return (writes_ & (other.reads_ | other.writes_)).any() || (other.writes_ & reads_).any();
+		}
+
+		// Runs for every system before any update of the frame
+		virtual void preUpdate(time_ms) {}
 		virtual void update(time_ms delta_time) = 0;
 	};
 }
\ No newline at end of file
@@ -1,20 +1,96 @@
 #pragma once
 #include <unordered_map>
 #include <memory>
+#include <memory_resource>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <vector>
 
 #include <ecs/core/system.h>
+#include <ecs/core/system_stats.h>
 #include <event/event_bus.h>
 #include <event/event_queue.h>
 #include <logging/logging.h>
 
 namespace ecs::core {
+	// Phases of one SystemManager::Update call in execution order
+	enum class Phase : size_t {
+		pre_update,
+		update,
+		event_flush,
+		structural_changes,
+		count
+	};
+
 	template<typename Events>
 	class SystemManager {
+		using QueuedEvent = std::pair<Events, ecs::event::Message>;
+		using Command = std::function<void()>;
+		using Clock = std::chrono::steady_clock;
+		using PhaseTimes = std::array<std::chrono::nanoseconds, static_cast<size_t>(Phase::count)>;
 	private:
-		std::unordered_map<size_t, Signature> signatures_{};
-		std::unordered_map<size_t, std::shared_ptr<System>> systems_{};
+		std::pmr::memory_resource* resource_;
+		std::pmr::unordered_map<size_t, Signature> signatures_;
+		std::pmr::unordered_map<size_t, std::shared_ptr<System>> systems_;
 		ecs::event::EventBus<Events> event_bus_;
-		ecs::event::EventQueue<Events> event_queue;
+		ecs::event::EventQueue<QueuedEvent> event_queue_;
+		// structural changes recorded during the frame
+		std::pmr::vector<Command> commands_;
+		std::pmr::vector<Command> playback_;
+		PhaseTimes phase_times_{};
+		std::array<TimingWindow, static_cast<size_t>(Phase::count)> phase_windows_{};
+		// update timings per system type id
+		std::pmr::unordered_map<size_t, TimingWindow> system_windows_;
+		std::pmr::unordered_map<size_t, size_t> system_entities_;
+		size_t stats_log_interval_{ 0 };
+		size_t frame_{ 0 };
+
+		template<typename F>
+		void runPhase(Phase phase, F&& fn) {
+			const auto start = Clock::now();
+			fn();
+			const auto duration = Clock::now() - start;
+			phase_times_[static_cast<size_t>(phase)] = duration;
+			phase_windows_[static_cast<size_t>(phase)].Add(duration);
+		}
+
+		void updateSystems(time_ms delta_time) {
+			for (const auto& [type_id, system] : systems_) {
+				const auto start = Clock::now();
+				system->update(delta_time);
+				system_windows_[type_id].Add(Clock::now() - start);
+				system_entities_[type_id] = system->Size();
+			}
+		}
+
+		SystemStats systemStats(size_t type_id) const {
+			SystemStats stats{};
+			if (const auto window = system_windows_.find(type_id); window != system_windows_.end()) {
+				stats.time = window->second.Stats();
+				stats.entities = system_entities_.at(type_id);
+			}
+			return stats;
+		}
+
+		void flushEvents() {
+			// events queued by observers are handled in the next frame
+			for (auto pending = event_queue_.Size(); pending > 0; pending--) {
+				const auto result = event_queue_.Dequeue();
+				const auto& [evnt, message] = result.data;
+				event_bus_.Dispatch(evnt, message);
+			}
+			event_bus_.Flush();
+		}
+
+		void playbackCommands() {
+			// commands recorded during playback are kept for the next frame
+			playback_.swap(commands_);
+			for (auto& command : playback_) {
+				command();
+			}
+			playback_.clear();
+		}
 
 		static inline size_t type_counter_{ 0 };
 		template<typename T>
@@ -23,12 +99,30 @@ namespace ecs::core {
 			return type_id;
 		}
 	public:
+		explicit SystemManager(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			resource_(resource),
+			signatures_(resource),
+			systems_(resource),
+			event_bus_(),
+			event_queue_(resource),
+			commands_(resource),
+			playback_(resource),
+			system_windows_(resource),
+			system_entities_(resource) {}
+
+		SystemManager(const SystemManager&) = delete;
+		SystemManager& operator=(const SystemManager&) = delete;
+
 		template<typename T>
 		err Register() {
 			const auto type_id = getTypeId<T>();
 
 			if (const auto element = systems_.find(type_id); element == systems_.end()) {
-				systems_[type_id] = std::make_shared<T>();
+				auto system = std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource_));
+				// a system missing some of its resources would be scheduled next to their writers
+				if (const auto error = system->ResourceError(); error != err::ok) return error;
+				system->UseMemoryResource(resource_);
+				systems_[type_id] = system;
 				return err::ok;
 			}
 			return err::already_registered;
@@ -39,7 +133,10 @@ namespace ecs::core {
 			const auto type_id = getTypeId<T>();
 
 			if (system == nullptr) return err::invalid_argument;
+			if (const auto error = system->ResourceError(); error != err::ok) return error;
 			if (const auto element = systems_.find(type_id); element == systems_.end()) {
+				// the caller shares the system and may keep it past the manager, so its
+				// entities stay on their own resource instead of the manager pools
 				systems_[type_id] = system;
 				return err::ok;
 			}
@@ -57,32 +154,45 @@ namespace ecs::core {
 			return err::not_registered;
 		}
 
+		// Updates the membership of entity in every system. A system that already has or lacks
+		// the entity is left as is, the result is its error when no membership changed at all.
 		err SetEntitySignature(Entity entity, Signature signature) {
 			bool set = false;
+			err unchanged = err::not_registered;
 
-			for (const auto [type_id, system] : systems_) {
+			for (const auto& [type_id, system] : systems_) {
 				
 				if (const auto& element = signatures_.find(type_id); element != signatures_.end()) {
 					const auto& system_signature = element->second;
 
-					if ((signature & system_signature) == system_signature) {
-						if (const auto error = system->Add(entity); error != err::ok) {
-							lLog(lWarn) << "Add entity " << entity << " to system " << type_id << " failed";
-							return error;
-						}
+					const auto error = (signature & system_signature) == system_signature ? system->Add(entity) : system->Remove(entity);
+					if (error == err::ok) {
 						set = true;
 					}
+					else if (error == err::already_registered || error == err::not_registered) {
+						unchanged = error;
+					}
 					else {
-						if (const auto error = system->Remove(entity); error != err::ok) {
-							lLog(lWarn) << "Remove entity " << entity << " from system " << type_id << " failed";
-							return error;
-						}
-						set = true;
+						lLog(lWarn) << "Update of entity " << entity << " in system " << type_id << " failed";
+						return error;
 					}
 				}
 			}
 			if(set) return err::ok;
-			return err::not_registered;
+			return unchanged;
+		}
+
+		// Adds entities sharing one signature to the matching systems, each system is matched once
+		void AddEntities(const Entity* entities, size_t count, Signature signature) {
+			for (const auto& [type_id, system] : systems_) {
+				if (const auto element = signatures_.find(type_id); element != signatures_.end()) {
+					if ((signature & element->second) == element->second) {
+						for (size_t index = 0; index < count; index++) {
+							system->Add(entities[index]);
+						}
+					}
+				}
+			}
 		}
 
 		err DestroyEntity(Entity entity) {
@@ -92,5 +202,122 @@ namespace ecs::core {
 			return err::ok;
 		}
 
+		// Rebuilds the entity sets of all systems from the given signatures,
+		// calls fn(add) where add(entity, signature) registers one entity
+		template<typename F>
+		void RebuildEntities(F&& fn) {
+			for (auto& [type_id, system] : systems_) {
+				system->Clear();
+			}
+			fn([this](Entity entity, Signature signature) {
+				for (auto& [type_id, system] : systems_) {
+					if (const auto element = signatures_.find(type_id); element != signatures_.end()) {
+						if ((signature & element->second) == element->second) {
+							system->Add(entity);
+						}
+					}
+				}
+			});
+		}
+
+		ecs::event::EventBus<Events>& GetEventBus() {
+			return event_bus_;
+		}
+
+		ecs::event::EventQueue<QueuedEvent>& GetEventQueue() {
+			return event_queue_;
+		}
+
+		// Queues an event, it is dispatched in the event flush phase
+		void Post(Events evnt, const ecs::event::Message& message = {}) {
+			event_queue_.Enqueue({ evnt, message });
+		}
+
+		// Records a structural change, it is executed after all events are flushed
+		void Defer(Command command) {
+			commands_.emplace_back(std::move(command));
+		}
+
+		// Runs one frame: pre-update, update, event flush and structural change playback
+		void Update(time_ms delta_time) {
+			runPhase(Phase::pre_update, [&]() {
+				for (const auto& [type_id, system] : systems_) {
+					system->preUpdate(delta_time);
+				}
+			});
+			runPhase(Phase::update, [&]() {
+				updateSystems(delta_time);
+			});
+			runPhase(Phase::event_flush, [&]() {
+				flushEvents();
+			});
+			runPhase(Phase::structural_changes, [&]() {
+				playbackCommands();
+			});
+
+			frame_++;
+			if (stats_log_interval_ && frame_ % stats_log_interval_ == 0) {
+				LogStats();
+			}
+		}
+
+		// Update timings of system T over the last STATS_WINDOW_SIZE frames
+		template<typename T>
+		result<SystemStats> GetStats() const {
+			const auto type_id = getTypeId<T>();
+
+			if (systems_.find(type_id) == systems_.end()) {
+				return {err::not_registered};
+			}
+			return {systemStats(type_id)};
+		}
+
+		// Stats of all systems by system type id
+		std::vector<std::pair<size_t, SystemStats>> GetStats() const {
+			std::vector<std::pair<size_t, SystemStats>> stats;
+			for (const auto& [type_id, system] : systems_) {
+				stats.emplace_back(type_id, systemStats(type_id));
+			}
+			return stats;
+		}
+
+		// Whether systems A and B access a resource in a way that prevents running them concurrently
+		template<typename A, typename B>
+		result<bool> Conflicts() const {
+			const auto first = systems_.find(getTypeId<A>());
+			const auto second = systems_.find(getTypeId<B>());
+			if (first == systems_.end() || second == systems_.end()) {
+				return {err::not_registered};
+			}
+			return {first->second->ConflictsWith(*second->second)};
+		}
+
+		TimingStats GetPhaseStats(Phase phase) const {
+			return phase_windows_[static_cast<size_t>(phase)].Stats();
+		}
+
+		// Logs all stats every interval frames, 0 disables it
+		void SetStatsLogInterval(size_t interval) {
+			stats_log_interval_ = interval;
+		}
+
+		void LogStats() const {
+			for (const auto& [type_id, stats] : GetStats()) {
+				lLogf(lInfo, "system {}: {} entities, min {}ns avg {}ns p95 {}ns p99 {}ns max {}ns", type_id, stats.entities,
+					stats.time.min, stats.time.avg, stats.time.p95, stats.time.p99, stats.time.max);
+			}
+			static constexpr const char* phase_names[] = { "pre-update", "update", "event flush", "structural changes" };
+			for (size_t phase = 0; phase < static_cast<size_t>(Phase::count); phase++) {
+				const auto stats = phase_windows_[phase].Stats();
+				lLogf(lInfo, "phase {}: min {}ns avg {}ns p95 {}ns p99 {}ns max {}ns", phase_names[phase],
+					stats.min, stats.avg, stats.p95, stats.p99, stats.max);
+			}
+		}
+
+		// Duration of the given phase in the last Update call
+		std::chrono::nanoseconds PhaseTime(Phase phase) const {
+			return phase_times_[static_cast<size_t>(phase)];
+		}
+
 	};
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace ecs::core {
+	static constexpr size_t STATS_WINDOW_SIZE = 128;
+
+	// Summary of the samples in a TimingWindow, times in nanoseconds
+	struct TimingStats {
+		uint64_t min{ 0 };
+		uint64_t avg{ 0 };
+		uint64_t p95{ 0 };
+		uint64_t p99{ 0 };
+		uint64_t max{ 0 };
+		size_t samples{ 0 };
+	};
+
+	struct SystemStats {
+		TimingStats time{};
+		// entities of the system in the last update
+		size_t entities{ 0 };
+	};
+
+	// Keeps the latest STATS_WINDOW_SIZE durations
+	class TimingWindow {
+	private:
+		std::array<uint64_t, STATS_WINDOW_SIZE> samples_{};
+		size_t count_{ 0 };
+	public:
+		void Add(std::chrono::nanoseconds duration) {
+			samples_[count_ % STATS_WINDOW_SIZE] = static_cast<uint64_t>(duration.count());
+			count_++;
+		}
+
+		TimingStats Stats() const {
+			TimingStats stats{};
+			stats.samples = std::min(count_, STATS_WINDOW_SIZE);
+			if (stats.samples == 0) {
+				return stats;
+			}
+
+			auto sorted = samples_;
+			std::sort(sorted.begin(), sorted.begin() + stats.samples);
+
+			uint64_t sum = 0;
+			for (size_t index = 0; index < stats.samples; index++) {
+				sum += sorted[index];
+			}
+			const auto percentile = [&](size_t percent) {
+				return sorted[(stats.samples - 1) * percent / 100];
+			};
+			stats.min = sorted[0];
+			stats.avg = sum / stats.samples;
+			stats.p95 = percentile(95);
+			stats.p99 = percentile(99);
+			stats.max = sorted[stats.samples - 1];
+			return stats;
+		}
+
+		void Clear() {
+			count_ = 0;
+		}
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <bitset>
+#include <cstdint>
 
 namespace ecs::core {
 
@@ -8,6 +9,8 @@ namespace ecs::core {
     using Entity = size_t;
 	using Signature = std::bitset<MAX_COMPONENTS>;
     using ComponentType = size_t;
+    // change tick of tracked components
+    using Version = uint32_t;
 
     enum class err {
         ok,
@@ -25,6 +28,8 @@ namespace ecs::core {
 
         empty,
 
+        not_serializable,
+
     };
 
     enum class components {
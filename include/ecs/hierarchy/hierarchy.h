@@ -0,0 +1,337 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include <ecs/core/types.h>
+
+namespace ecs::hierarchy {
+	using ecs::core::Entity;
+	using ecs::core::err;
+	using ecs::core::result;
+
+	static constexpr Entity no_parent = ecs::core::MAX_ENTITY_COUNT;
+
+	// 2D transform, children are moved, rotated and scaled with their parent
+	struct Transform {
+		float x_{ 0 }, y_{ 0 };
+		float rotation_{ 0 };
+		float scale_{ 1 };
+	};
+
+	// World transform of a child with the given local transform
+	inline Transform Combine(const Transform& parent, const Transform& local) {
+		const auto cos = std::cos(parent.rotation_) * parent.scale_;
+		const auto sin = std::sin(parent.rotation_) * parent.scale_;
+		return {
+			parent.x_ + cos * local.x_ - sin * local.y_,
+			parent.y_ + sin * local.x_ + cos * local.y_,
+			parent.rotation_ + local.rotation_,
+			parent.scale_ * local.scale_
+		};
+	}
+
+	// Parent/child relations of entities with their local and world transforms.
+	// Nodes are stored breadth first in dense arrays, sorted by depth, so propagation
+	// is one forward pass and every depth level is a contiguous range. Structural
+	// changes only mark the order as stale, it is rebuilt once before the next propagation.
+	// The hierarchy is not tied to a world: call Remove when destroying an entity, its id
+	// may come back from CreateEntity and is refused by Add until the old node is gone.
+	class Hierarchy {
+		static constexpr uint32_t no_index = UINT32_MAX;
+		static constexpr Entity no_link = ecs::core::MAX_ENTITY_COUNT;
+
+		struct Node {
+			Entity entity;
+			Entity parent;
+			// valid after a rebuild
+			uint32_t parent_index;
+		};
+
+		// children of a node as a doubly linked list, indexed by entity
+		struct Links {
+			Entity first_child;
+			Entity previous_sibling;
+			Entity next_sibling;
+		};
+	private:
+		// nodes_[i] owns local_[i] and world_[i]
+		std::pmr::vector<Node> nodes_;
+		std::pmr::vector<Transform> local_;
+		std::pmr::vector<Transform> world_;
+		// first index of every depth level followed by the end
+		std::pmr::vector<size_t> levels_;
+		std::array<uint32_t, ecs::core::MAX_ENTITY_COUNT> index_{};
+		std::array<Links, ecs::core::MAX_ENTITY_COUNT> links_{};
+		// scratch of rebuild, kept to avoid allocations
+		std::pmr::vector<uint32_t> depths_;
+		std::pmr::vector<uint32_t> order_;
+		std::pmr::vector<Node> sorted_nodes_;
+		std::pmr::vector<Transform> sorted_local_;
+		bool dirty_{ false };
+
+		bool contains(Entity entity) const {
+			return entity < ecs::core::MAX_ENTITY_COUNT && index_[entity] != no_index;
+		}
+
+		// Makes entity the first child of parent, roots are not linked
+		void link(Entity entity, Entity parent) {
+			auto& links = links_[entity];
+			links.previous_sibling = no_link;
+			links.next_sibling = no_link;
+			if (parent == no_parent) {
+				return;
+			}
+			links.next_sibling = links_[parent].first_child;
+			if (links.next_sibling != no_link) {
+				links_[links.next_sibling].previous_sibling = entity;
+			}
+			links_[parent].first_child = entity;
+		}
+
+		void unlink(Entity entity, Entity parent) {
+			if (parent == no_parent) {
+				return;
+			}
+			const auto& links = links_[entity];
+			if (links.previous_sibling != no_link) {
+				links_[links.previous_sibling].next_sibling = links.next_sibling;
+			}
+			else {
+				links_[parent].first_child = links.next_sibling;
+			}
+			if (links.next_sibling != no_link) {
+				links_[links.next_sibling].previous_sibling = links.previous_sibling;
+			}
+		}
+
+		// Depth of every node, parents are resolved through index_
+		void computeDepths() {
+			static constexpr uint32_t unknown = UINT32_MAX;
+			depths_.assign(nodes_.size(), unknown);
+			for (size_t start = 0; start < nodes_.size(); start++) {
+				// walk up to a known depth, then write the depths back down the chain
+				uint32_t length = 0;
+				auto index = static_cast<uint32_t>(start);
+				while (depths_[index] == unknown && nodes_[index].parent != no_parent) {
+					index = index_[nodes_[index].parent];
+					length++;
+				}
+				if (depths_[index] == unknown) {
+					depths_[index] = 0;
+				}
+				auto depth = depths_[index] + length;
+				for (index = static_cast<uint32_t>(start); depths_[index] == unknown; index = index_[nodes_[index].parent]) {
+					depths_[index] = depth--;
+				}
+			}
+		}
+
+		// Counting sort by depth, stable so siblings keep their relative order
+		void rebuild() {
+			computeDepths();
+			levels_.clear();
+			for (const auto depth : depths_) {
+				if (depth + 2 > levels_.size()) {
+					levels_.resize(depth + 2, 0);
+				}
+				levels_[depth + 1]++;
+			}
+			for (size_t level = 1; level < levels_.size(); level++) {
+				levels_[level] += levels_[level - 1];
+			}
+
+			order_.assign(levels_.begin(), levels_.end() - (levels_.empty() ? 0 : 1));
+			sorted_nodes_.resize(nodes_.size());
+			sorted_local_.resize(local_.size());
+			for (size_t index = 0; index < nodes_.size(); index++) {
+				const auto position = order_[depths_[index]]++;
+				sorted_nodes_[position] = nodes_[index];
+				sorted_local_[position] = local_[index];
+			}
+			nodes_.swap(sorted_nodes_);
+			local_.swap(sorted_local_);
+
+			for (size_t index = 0; index < nodes_.size(); index++) {
+				index_[nodes_[index].entity] = static_cast<uint32_t>(index);
+			}
+			for (auto& node : nodes_) {
+				node.parent_index = node.parent == no_parent ? no_index : index_[node.parent];
+			}
+			dirty_ = false;
+		}
+
+		// World transforms of [begin, end), the parents have to be up to date
+		void update(size_t begin, size_t end) {
+			for (auto index = begin; index < end; index++) {
+				const auto parent = nodes_[index].parent_index;
+				world_[index] = parent == no_index ? local_[index] : Combine(world_[parent], local_[index]);
+			}
+		}
+	public:
+		explicit Hierarchy(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			nodes_(resource),
+			local_(resource),
+			world_(resource),
+			levels_(resource),
+			depths_(resource),
+			order_(resource),
+			sorted_nodes_(resource),
+			sorted_local_(resource) {
+			index_.fill(no_index);
+			links_.fill({ no_link, no_link, no_link });
+		}
+
+		// Adds entity below parent, no_parent adds a root
+		err Add(Entity entity, const Transform& local = {}, Entity parent = no_parent) {
+			if (entity >= ecs::core::MAX_ENTITY_COUNT) {
+				return err::entity_limit;
+			}
+			if (contains(entity)) {
+				return err::already_registered;
+			}
+			if (parent != no_parent && !contains(parent)) {
+				return err::no_entity;
+			}
+			index_[entity] = static_cast<uint32_t>(nodes_.size());
+			links_[entity].first_child = no_link;
+			link(entity, parent);
+			nodes_.push_back({ entity, parent, no_index });
+			local_.push_back(local);
+			world_.push_back(local);
+			dirty_ = true;
+			return err::ok;
+		}
+
+		// Removes entity, its children become roots
+		err Remove(Entity entity) {
+			if (!contains(entity)) {
+				return err::no_entity;
+			}
+			const auto index = index_[entity];
+			unlink(entity, nodes_[index].parent);
+			for (auto child = links_[entity].first_child; child != no_link;) {
+				const auto next = links_[child].next_sibling;
+				nodes_[index_[child]].parent = no_parent;
+				link(child, no_parent);
+				child = next;
+			}
+			links_[entity].first_child = no_link;
+			nodes_[index] = nodes_.back();
+			local_[index] = local_.back();
+			world_[index] = world_.back();
+			index_[nodes_[index].entity] = index;
+			nodes_.pop_back();
+			local_.pop_back();
+			world_.pop_back();
+			index_[entity] = no_index;
+			dirty_ = true;
+			return err::ok;
+		}
+
+		// Moves entity with its subtree below parent, no_parent makes it a root.
+		// The local transform is kept, the world transform follows the new parent.
+		err SetParent(Entity entity, Entity parent) {
+			if (!contains(entity) || (parent != no_parent && !contains(parent))) {
+				return err::no_entity;
+			}
+			for (auto ancestor = parent; ancestor != no_parent; ancestor = nodes_[index_[ancestor]].parent) {
+				if (ancestor == entity) {
+					return err::invalid_argument;
+				}
+			}
+			auto& node = nodes_[index_[entity]];
+			unlink(entity, node.parent);
+			link(entity, parent);
+			node.parent = parent;
+			dirty_ = true;
+			return err::ok;
+		}
+
+		result<Entity> Parent(Entity entity) const {
+			if (!contains(entity)) {
+				return {err::no_entity};
+			}
+			return {nodes_[index_[entity]].parent};
+		}
+
+		// Calls fn(child) for the direct children of entity, the last added first
+		template<typename F>
+		err ForEachChild(Entity entity, F&& fn) const {
+			if (!contains(entity)) {
+				return err::no_entity;
+			}
+			for (auto child = links_[entity].first_child; child != no_link; child = links_[child].next_sibling) {
+				fn(child);
+			}
+			return err::ok;
+		}
+
+		result<Transform> Local(Entity entity) const {
+			if (!contains(entity)) {
+				return {err::no_entity};
+			}
+			return {local_[index_[entity]]};
+		}
+
+		err SetLocal(Entity entity, const Transform& local) {
+			if (!contains(entity)) {
+				return err::no_entity;
+			}
+			local_[index_[entity]] = local;
+			return err::ok;
+		}
+
+		// World transform as of the last propagation
+		result<Transform> World(Entity entity) const {
+			if (!contains(entity)) {
+				return {err::no_entity};
+			}
+			return {world_[index_[entity]]};
+		}
+
+		// Computes all world transforms in one forward pass
+		void Propagate() {
+			if (dirty_) {
+				rebuild();
+			}
+			update(0, nodes_.size());
+		}
+
+		// Computes the world transforms level by level. for_level(begin, end, update) is called
+		// once per depth level and may split [begin, end) across threads, calling update(first, last)
+		// for every part. It has to return once the whole range is updated.
+		template<typename F>
+		void Propagate(F&& for_level) {
+			if (dirty_) {
+				rebuild();
+			}
+			const auto kernel = [this](size_t first, size_t last) {
+				update(first, last);
+			};
+			for (size_t level = 0; level + 1 < levels_.size(); level++) {
+				for_level(levels_[level], levels_[level + 1], kernel);
+			}
+		}
+
+		// Calls fn(entity, world transform) breadth first, parents before their children
+		template<typename F>
+		void ForEach(F&& fn) const {
+			for (size_t index = 0; index < nodes_.size(); index++) {
+				fn(nodes_[index].entity, world_[index]);
+			}
+		}
+
+		size_t Size() const {
+			return nodes_.size();
+		}
+
+		// Number of depth levels as of the last propagation
+		size_t Levels() const {
+			return levels_.empty() ? 0 : levels_.size() - 1;
+		}
+	};
+}
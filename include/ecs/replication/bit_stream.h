@@ -0,0 +1,118 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <ecs/core/types.h>
+
+namespace ecs::replication {
+	// Number of bits needed to store values up to max
+	constexpr unsigned BitsFor(uint64_t max) {
+		unsigned bits = 1;
+		while (bits < 64 && (max >> bits) != 0) {
+			bits++;
+		}
+		return bits;
+	}
+
+	static constexpr unsigned ENTITY_BITS = BitsFor(ecs::core::MAX_ENTITY_COUNT);
+
+	// Packs values with an exact bit width, least significant bit first
+	class BitWriter {
+	private:
+		std::vector<uint8_t> bytes_{};
+		size_t bits_{ 0 };
+	public:
+		void WriteBits(uint64_t value, unsigned count) {
+			for (unsigned bit = 0; bit < count; bit++, bits_++) {
+				if ((bits_ & 7) == 0) {
+					bytes_.push_back(0);
+				}
+				if ((value >> bit) & 1) {
+					bytes_.back() |= static_cast<uint8_t>(1 << (bits_ & 7));
+				}
+			}
+		}
+
+		void WriteBool(bool value) {
+			WriteBits(value ? 1 : 0, 1);
+		}
+
+		void WriteBytes(const void* data, size_t size) {
+			const auto* bytes = static_cast<const uint8_t*>(data);
+			for (size_t index = 0; index < size; index++) {
+				WriteBits(bytes[index], 8);
+			}
+		}
+
+		// Maps value from [min, max] onto count bits, values outside are clamped.
+		// An empty range writes zero, which reads back as min.
+		void WriteQuantized(float value, float min, float max, unsigned count) {
+			if (!(max > min)) {
+				WriteBits(0, count);
+				return;
+			}
+			const auto steps = static_cast<float>((uint64_t{ 1 } << count) - 1);
+			const auto clamped = value < min ? min : (value > max ? max : value);
+			WriteBits(static_cast<uint64_t>(std::lround((clamped - min) / (max - min) * steps)), count);
+		}
+
+		void Clear() {
+			bytes_.clear();
+			bits_ = 0;
+		}
+
+		const std::vector<uint8_t>& Bytes() const {
+			return bytes_;
+		}
+
+		size_t Bits() const {
+			return bits_;
+		}
+	};
+
+	// Reads what BitWriter wrote. Reading past the end yields zeros and sets Overrun.
+	class BitReader {
+	private:
+		const uint8_t* data_;
+		size_t size_bits_;
+		size_t bits_{ 0 };
+		bool overrun_{ false };
+	public:
+		BitReader(const uint8_t* data, size_t size) : data_(data), size_bits_(size * 8) {}
+
+		uint64_t ReadBits(unsigned count) {
+			if (count > size_bits_ - bits_) {
+				overrun_ = true;
+				bits_ = size_bits_;
+				return 0;
+			}
+			uint64_t value = 0;
+			for (unsigned bit = 0; bit < count; bit++, bits_++) {
+				value |= static_cast<uint64_t>((data_[bits_ >> 3] >> (bits_ & 7)) & 1) << bit;
+			}
+			return value;
+		}
+
+		bool ReadBool() {
+			return ReadBits(1) != 0;
+		}
+
+		void ReadBytes(void* data, size_t size) {
+			auto* bytes = static_cast<uint8_t*>(data);
+			for (size_t index = 0; index < size; index++) {
+				bytes[index] = static_cast<uint8_t>(ReadBits(8));
+			}
+		}
+
+		float ReadQuantized(float min, float max, unsigned count) {
+			const auto steps = static_cast<float>((uint64_t{ 1 } << count) - 1);
+			return min + static_cast<float>(ReadBits(count)) / steps * (max - min);
+		}
+
+		bool Overrun() const {
+			return overrun_;
+		}
+	};
+}
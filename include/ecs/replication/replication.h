@@ -0,0 +1,362 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <ecs/core/ecs.h>
+#include <ecs/replication/bit_stream.h>
+#include <ecs/replication/transport.h>
+
+namespace ecs::replication {
+	using ecs::core::Entity;
+	using ecs::core::Signature;
+	using ecs::core::Version;
+	using ecs::core::err;
+	using ecs::core::result;
+
+	static constexpr uint64_t REPLICATION_MAGIC = 0x5245;
+	static constexpr unsigned REPLICATION_MAGIC_BITS = 16;
+	static constexpr unsigned CHANNEL_BITS = BitsFor(ecs::core::MAX_COMPONENTS);
+
+	// Wire encoding of a replicated component. The default copies trivially copyable
+	// types byte by byte. Specialize for bit packed or quantized encodings with
+	//   static void Encode(BitWriter&, const T&);
+	//   static void Decode(BitReader&, T&);
+	template<typename T>
+	struct Replicated {
+		static void Encode(BitWriter& writer, const T& component) {
+			static_assert(std::is_trivially_copyable_v<T>, "Specialize Replicated<T> for types that are not trivially copyable");
+			writer.WriteBytes(&component, sizeof(T));
+		}
+
+		static void Decode(BitReader& reader, T& component) {
+			reader.ReadBytes(&component, sizeof(T));
+		}
+	};
+
+	// Packet layout, lists are terminated by a zero bit:
+	//   magic, tick, channel count
+	//   destroyed entities, created entities
+	//   per channel: removed components, changed components with their data
+
+	// Encodes the changes of an authoritative world since the last packet.
+	// Every delta assumes the client applied all previous ones, send them over a reliable,
+	// ordered transport. Replicated components need change tracking, see ecs::core::TrackChanges.
+	template<typename Events>
+	class ReplicationServer {
+		using World = ecs::core::EntityComponentSystem<Events>;
+
+		struct Channel {
+			ecs::core::ComponentType type;
+			// null for tags, they are sent from the signatures
+			void (*encode)(World&, Version, BitWriter&);
+		};
+	private:
+		World& world_;
+		std::vector<Channel> channels_{};
+		// state the last delta was computed against
+		std::bitset<ecs::core::MAX_ENTITY_COUNT> living_{};
+		std::array<Signature, ecs::core::MAX_ENTITY_COUNT> signatures_{};
+		std::array<Signature, ecs::core::MAX_ENTITY_COUNT> current_signatures_{};
+		Version since_{ 0 };
+		BitWriter writer_{};
+
+		template<typename T>
+		static void encodeChanged(World& world, Version since, BitWriter& writer) {
+			world.template ForEachChanged<T>(since, [&writer](Entity entity, const T& component) {
+				writer.WriteBool(true);
+				writer.WriteBits(entity, ENTITY_BITS);
+				Replicated<T>::Encode(writer, component);
+			});
+			writer.WriteBool(false);
+		}
+
+		// Writes the difference between the baseline and the current world,
+		// a full encode compares against an empty world and keeps the baseline
+		void encode(bool full, Version since) {
+			writer_.Clear();
+			writer_.WriteBits(REPLICATION_MAGIC, REPLICATION_MAGIC_BITS);
+			writer_.WriteBits(world_.Tick(), 32);
+			writer_.WriteBits(channels_.size(), CHANNEL_BITS);
+
+			const auto living = full ? std::bitset<ecs::core::MAX_ENTITY_COUNT>{} : living_;
+			std::bitset<ecs::core::MAX_ENTITY_COUNT> current{};
+			for (Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity++) {
+				if (const auto signature = world_.GetSignature(entity); signature.error == err::ok) {
+					current.set(entity);
+					current_signatures_[entity] = signature.data;
+				}
+				else {
+					current_signatures_[entity].reset();
+				}
+			}
+
+			const auto writeEntities = [this](const std::bitset<ecs::core::MAX_ENTITY_COUNT>& entities) {
+				for (Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity++) {
+					if (entities[entity]) {
+						writer_.WriteBool(true);
+						writer_.WriteBits(entity, ENTITY_BITS);
+					}
+				}
+				writer_.WriteBool(false);
+			};
+			writeEntities(living & ~current);
+			writeEntities(current & ~living);
+
+			for (const auto& channel : channels_) {
+				for (Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity++) {
+					if (living[entity] && current[entity] && signatures_[entity][channel.type] && !current_signatures_[entity][channel.type]) {
+						writer_.WriteBool(true);
+						writer_.WriteBits(entity, ENTITY_BITS);
+					}
+				}
+				writer_.WriteBool(false);
+				if (channel.encode) {
+					channel.encode(world_, since, writer_);
+					continue;
+				}
+				for (Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity++) {
+					if (current_signatures_[entity][channel.type] && !(living[entity] && signatures_[entity][channel.type])) {
+						writer_.WriteBool(true);
+						writer_.WriteBits(entity, ENTITY_BITS);
+					}
+				}
+				writer_.WriteBool(false);
+			}
+
+			if (!full) {
+				living_ = current;
+				signatures_.swap(current_signatures_);
+			}
+		}
+	public:
+		explicit ReplicationServer(World& world) : world_(world) {}
+
+		// Components are matched by registration order, the client has to replicate the same types in the same order
+		template<typename T>
+		err Replicate() {
+			static_assert(ecs::core::is_tag_v<T> || ecs::core::TrackChanges<T>::enabled, "Replicated components need change tracking");
+			if (channels_.size() >= ecs::core::MAX_COMPONENTS) {
+				return err::invalid_argument;
+			}
+			const auto type = world_.template GetComponentType<T>();
+			for (const auto& channel : channels_) {
+				if (channel.type == type) {
+					return err::already_registered;
+				}
+			}
+			if constexpr (ecs::core::is_tag_v<T>) {
+				channels_.push_back({ type, nullptr });
+			}
+			else {
+				channels_.push_back({ type, &encodeChanged<T> });
+			}
+			return err::ok;
+		}
+
+		// Changes since the previous packet, the first packet holds the whole world
+		const Packet& Encode() {
+			const auto tick = world_.Tick();
+			encode(false, since_);
+			since_ = tick;
+			return writer_.Bytes();
+		}
+
+		// The whole world for a client joining late, deltas of other clients are not affected
+		const Packet& EncodeFull() {
+			encode(true, 0);
+			return writer_.Bytes();
+		}
+
+		void Send(Transport& transport) {
+			const auto& packet = Encode();
+			transport.Send(packet.data(), packet.size());
+		}
+
+		void SendFull(Transport& transport) {
+			const auto& packet = EncodeFull();
+			transport.Send(packet.data(), packet.size());
+		}
+	};
+
+	// Applies server packets to a local world. Server entities are mapped to local ones,
+	// applying a packet twice or a full state on top of deltas is harmless.
+	template<typename Events>
+	class ReplicationClient {
+		using World = ecs::core::EntityComponentSystem<Events>;
+		static constexpr Entity no_entity = ecs::core::MAX_ENTITY_COUNT;
+
+		struct Channel {
+			void (*apply)(World&, Entity, BitReader&);
+			void (*remove)(World&, Entity);
+			// reads the data of a changed component without applying it
+			void (*skip)(BitReader&);
+		};
+	private:
+		World& world_;
+		std::vector<Channel> channels_{};
+		std::array<Entity, ecs::core::MAX_ENTITY_COUNT> local_{};
+		Version tick_{ 0 };
+		Packet packet_{};
+
+		template<typename T>
+		static void applyComponent(World& world, Entity entity, BitReader& reader) {
+			if constexpr (ecs::core::is_tag_v<T>) {
+				if (!world.template HasComponent<T>(entity)) {
+					world.AddComponent(entity, T{});
+				}
+			}
+			else if (auto existing = world.template GetMutableComponent<T>(entity); existing.error == err::ok) {
+				Replicated<T>::Decode(reader, *existing.data);
+			}
+			else {
+				T component{};
+				Replicated<T>::Decode(reader, component);
+				world.AddComponent(entity, component);
+			}
+		}
+
+		template<typename T>
+		static void removeComponent(World& world, Entity entity) {
+			world.template RemoveComponent<T>(entity);
+		}
+
+		template<typename T>
+		static void skipComponent(BitReader& reader) {
+			if constexpr (!ecs::core::is_tag_v<T>) {
+				T component{};
+				Replicated<T>::Decode(reader, component);
+			}
+		}
+
+		// Reads the whole packet without touching the world, a broken packet is rejected before anything is applied
+		err validate(const uint8_t* data, size_t size) const {
+			BitReader reader(data, size);
+			if (reader.ReadBits(REPLICATION_MAGIC_BITS) != REPLICATION_MAGIC) {
+				return err::invalid_argument;
+			}
+			reader.ReadBits(32);
+			if (reader.ReadBits(CHANNEL_BITS) != channels_.size()) {
+				return err::invalid_signature;
+			}
+
+			const auto skipEntities = [&reader]() {
+				while (reader.ReadBool()) {
+					reader.ReadBits(ENTITY_BITS);
+				}
+			};
+			const auto validEntity = [&reader]() {
+				return reader.ReadBits(ENTITY_BITS) < ecs::core::MAX_ENTITY_COUNT;
+			};
+			skipEntities();
+			while (reader.ReadBool()) {
+				if (!validEntity()) {
+					return err::invalid_argument;
+				}
+			}
+			for (const auto& channel : channels_) {
+				skipEntities();
+				while (reader.ReadBool()) {
+					if (!validEntity()) {
+						return err::invalid_argument;
+					}
+					channel.skip(reader);
+				}
+			}
+			return reader.Overrun() ? err::invalid_argument : err::ok;
+		}
+
+		// Local entity of a server entity, created on first use
+		result<Entity> mapEntity(Entity remote) {
+			if (local_[remote] == no_entity) {
+				const auto created = world_.CreateEntity();
+				if (created.error != err::ok) {
+					return created;
+				}
+				local_[remote] = created.data;
+			}
+			return { local_[remote] };
+		}
+	public:
+		explicit ReplicationClient(World& world) : world_(world) {
+			local_.fill(no_entity);
+		}
+
+		template<typename T>
+		err Replicate() {
+			if (channels_.size() >= ecs::core::MAX_COMPONENTS) {
+				return err::invalid_argument;
+			}
+			channels_.push_back({ &applyComponent<T>, &removeComponent<T>, &skipComponent<T> });
+			return err::ok;
+		}
+
+		err Apply(const uint8_t* data, size_t size) {
+			if (const auto error = validate(data, size); error != err::ok) {
+				return error;
+			}
+			BitReader reader(data, size);
+			reader.ReadBits(REPLICATION_MAGIC_BITS);
+			const auto tick = static_cast<Version>(reader.ReadBits(32));
+			reader.ReadBits(CHANNEL_BITS);
+
+			while (reader.ReadBool()) {
+				const auto remote = static_cast<Entity>(reader.ReadBits(ENTITY_BITS));
+				if (remote < ecs::core::MAX_ENTITY_COUNT && local_[remote] != no_entity) {
+					world_.DestroyEntity(local_[remote]);
+					local_[remote] = no_entity;
+				}
+			}
+			while (reader.ReadBool()) {
+				const auto remote = static_cast<Entity>(reader.ReadBits(ENTITY_BITS));
+				if (const auto error = mapEntity(remote).error; error != err::ok) {
+					return error;
+				}
+			}
+
+			for (const auto& channel : channels_) {
+				while (reader.ReadBool()) {
+					const auto remote = static_cast<Entity>(reader.ReadBits(ENTITY_BITS));
+					if (remote < ecs::core::MAX_ENTITY_COUNT && local_[remote] != no_entity) {
+						channel.remove(world_, local_[remote]);
+					}
+				}
+				while (reader.ReadBool()) {
+					const auto remote = static_cast<Entity>(reader.ReadBits(ENTITY_BITS));
+					const auto local = mapEntity(remote);
+					if (local.error != err::ok) {
+						return local.error;
+					}
+					channel.apply(world_, local.data, reader);
+				}
+			}
+
+			tick_ = tick;
+			return err::ok;
+		}
+
+		// Applies all pending packets, stops at the first broken one
+		err Receive(Transport& transport) {
+			while (transport.Receive(packet_)) {
+				if (const auto error = Apply(packet_.data(), packet_.size()); error != err::ok) {
+					return error;
+				}
+			}
+			return err::ok;
+		}
+
+		result<Entity> LocalEntity(Entity remote) const {
+			if (remote < ecs::core::MAX_ENTITY_COUNT && local_[remote] != no_entity) {
+				return { local_[remote] };
+			}
+			return { err::no_entity };
+		}
+
+		// Server tick of the last applied packet
+		Version Tick() const {
+			return tick_;
+		}
+	};
+}
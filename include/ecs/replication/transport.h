@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ecs::replication {
+	using Packet = std::vector<uint8_t>;
+
+	// Packet channel between server and client. Deltas build on every packet sent before,
+	// so delivery has to be reliable and ordered, e.g. TCP or a reliable UDP layer.
+	class Transport {
+	public:
+		virtual ~Transport() = default;
+
+		virtual void Send(const uint8_t* data, size_t size) = 0;
+		// Returns false if no packet is pending
+		virtual bool Receive(Packet& packet) = 0;
+	};
+
+	// In process transport, packets arrive in order and are never lost
+	class LoopbackTransport : public Transport {
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Packet> packets;
+		};
+	private:
+		std::shared_ptr<Queue> incoming_;
+		std::shared_ptr<Queue> outgoing_;
+
+		LoopbackTransport(std::shared_ptr<Queue> incoming, std::shared_ptr<Queue> outgoing) :
+			incoming_(std::move(incoming)), outgoing_(std::move(outgoing)) {}
+	public:
+		// Creates two connected ends
+		static std::pair<LoopbackTransport, LoopbackTransport> Pair() {
+			auto first = std::make_shared<Queue>();
+			auto second = std::make_shared<Queue>();
+			return { LoopbackTransport(first, second), LoopbackTransport(second, first) };
+		}
+
+		virtual void Send(const uint8_t* data, size_t size) override {
+			std::lock_guard<std::mutex> lock(outgoing_->mutex);
+			outgoing_->packets.emplace_back(data, data + size);
+		}
+
+		virtual bool Receive(Packet& packet) override {
+			std::lock_guard<std::mutex> lock(incoming_->mutex);
+			if (incoming_->packets.empty()) {
+				return false;
+			}
+			packet = std::move(incoming_->packets.front());
+			incoming_->packets.pop_front();
+			return true;
+		}
+
+		// Number of packets waiting for this end
+		size_t Pending() const {
+			std::lock_guard<std::mutex> lock(incoming_->mutex);
+			return incoming_->packets.size();
+		}
+	};
+}
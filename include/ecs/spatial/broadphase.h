@@ -0,0 +1,186 @@
+#pragma once
+#include <bitset>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ECS_SPATIAL_SSE 1
+#endif
+
+#include <ecs/core/ecs.h>
+
+namespace ecs::spatial {
+	using ecs::core::Entity;
+
+	// Axis aligned bounding box component, borders touching counts as overlap
+	struct Aabb {
+		float min_x_{ 0 }, min_y_{ 0 };
+		float max_x_{ 0 }, max_y_{ 0 };
+	};
+
+	struct CollisionPair {
+		Entity first;
+		Entity second;
+	};
+
+	using CollisionPairs = std::pmr::vector<CollisionPair>;
+
+	// Sweep and prune broadphase over the Aabb components of a world. The boxes are kept
+	// sorted by their lower x endpoint and re-sorted by insertion sort every update, which
+	// is close to linear as boxes move little between frames. The sweep tests four boxes per
+	// SSE instruction where available. All overlapping pairs of a frame are collected in
+	// one array and published as a single event instead of one event per pair.
+	template<typename Events>
+	class SweepAndPrune : public ecs::core::System {
+		using World = ecs::core::EntityComponentSystem<Events>;
+		// boxes past the end that never overlap, the SSE loads read up to 3 of them
+		static constexpr size_t padding = 4;
+
+		struct Proxy {
+			float min_x;
+			Entity entity;
+		};
+	private:
+		World& world_;
+		// bounds of the current frame by entity
+		std::pmr::vector<Aabb> bounds_;
+		std::bitset<ecs::core::MAX_ENTITY_COUNT> present_{};
+		std::bitset<ecs::core::MAX_ENTITY_COUNT> listed_{};
+		// sorted by min_x, kept between frames
+		std::pmr::vector<Proxy> proxies_;
+		// structure of arrays copy of the sorted boxes for the sweep
+		std::pmr::vector<float> min_x_;
+		std::pmr::vector<float> max_x_;
+		std::pmr::vector<float> min_y_;
+		std::pmr::vector<float> max_y_;
+		CollisionPairs pairs_;
+		std::optional<Events> pairs_event_{};
+
+		// Refreshes the proxies, keeps the order of known ones and appends new ones
+		void sync() {
+			present_.reset();
+			world_.template ForEachComponent<Aabb>([this](Entity entity, const Aabb& bounds) {
+				bounds_[entity] = bounds;
+				present_.set(entity);
+				if (!listed_[entity]) {
+					proxies_.push_back({ bounds.min_x_, entity });
+					listed_.set(entity);
+				}
+			});
+
+			size_t kept = 0;
+			for (const auto& proxy : proxies_) {
+				if (present_[proxy.entity]) {
+					proxies_[kept++] = { bounds_[proxy.entity].min_x_, proxy.entity };
+				}
+				else {
+					listed_.reset(proxy.entity);
+				}
+			}
+			proxies_.resize(kept);
+		}
+
+		void sort() {
+			for (size_t index = 1; index < proxies_.size(); index++) {
+				const auto proxy = proxies_[index];
+				auto position = index;
+				for (; position > 0 && proxies_[position - 1].min_x > proxy.min_x; position--) {
+					proxies_[position] = proxies_[position - 1];
+				}
+				proxies_[position] = proxy;
+			}
+		}
+
+		void fill() {
+			const auto size = proxies_.size();
+			min_x_.assign(size + padding, std::numeric_limits<float>::infinity());
+			max_x_.assign(size + padding, -std::numeric_limits<float>::infinity());
+			min_y_.assign(size + padding, std::numeric_limits<float>::infinity());
+			max_y_.assign(size + padding, -std::numeric_limits<float>::infinity());
+			for (size_t index = 0; index < size; index++) {
+				const auto& bounds = bounds_[proxies_[index].entity];
+				min_x_[index] = bounds.min_x_;
+				max_x_[index] = bounds.max_x_;
+				min_y_[index] = bounds.min_y_;
+				max_y_[index] = bounds.max_y_;
+			}
+		}
+
+		// Pairs of box index with every later box starting before it ends
+		void sweep() {
+			pairs_.clear();
+			const auto size = proxies_.size();
+			for (size_t index = 0; index < size; index++) {
+				const auto max_x = max_x_[index];
+				const auto min_y = min_y_[index];
+				const auto max_y = max_y_[index];
+#ifdef ECS_SPATIAL_SSE
+				const auto max_x4 = _mm_set1_ps(max_x);
+				const auto min_y4 = _mm_set1_ps(min_y);
+				const auto max_y4 = _mm_set1_ps(max_y);
+				for (auto other = index + 1; other < size; other += 4) {
+					const auto in_x = _mm_cmple_ps(_mm_loadu_ps(&min_x_[other]), max_x4);
+					// sorted by min_x, once all four start behind the box none of the later ones overlap
+					if (_mm_movemask_ps(in_x) == 0) {
+						break;
+					}
+					const auto in_y = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&min_y_[other]), max_y4), _mm_cmpge_ps(_mm_loadu_ps(&max_y_[other]), min_y4));
+					auto mask = _mm_movemask_ps(_mm_and_ps(in_x, in_y));
+					// an unbounded box reaches the padding, lanes past the last box are dropped
+					if (size - other < 4) {
+						mask &= (1 << (size - other)) - 1;
+					}
+					if (mask) {
+						for (size_t lane = 0; lane < 4; lane++) {
+							if (mask & (1 << lane)) {
+								pairs_.push_back({ proxies_[index].entity, proxies_[other + lane].entity });
+							}
+						}
+					}
+				}
+#else
+				for (auto other = index + 1; other < size && min_x_[other] <= max_x; other++) {
+					if (min_y_[other] <= max_y && max_y_[other] >= min_y) {
+						pairs_.push_back({ proxies_[index].entity, proxies_[other].entity });
+					}
+				}
+#endif
+			}
+		}
+	public:
+		explicit SweepAndPrune(World& world, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			world_(world),
+			bounds_(ecs::core::MAX_ENTITY_COUNT, resource),
+			proxies_(resource),
+			min_x_(resource),
+			max_x_(resource),
+			min_y_(resource),
+			max_y_(resource),
+			pairs_(resource) {}
+
+		virtual void update(ecs::core::time_ms) override {
+			sync();
+			sort();
+			fill();
+			sweep();
+			if (pairs_event_) {
+				world_.GetEventBus().Dispatch(*pairs_event_, ecs::event::Message(&std::as_const(pairs_)));
+			}
+		}
+
+		// Dispatches evnt once per update, the message data is a const CollisionPairs* to Pairs()
+		void PublishPairs(Events evnt) {
+			pairs_event_ = evnt;
+		}
+
+		// Overlapping pairs found by the last update, the first entity starts further left.
+		// Valid until the next update.
+		const CollisionPairs& Pairs() const {
+			return pairs_;
+		}
+	};
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include <ecs/core/types.h>
+
+namespace ecs::spatial {
+	using ecs::core::Entity;
+	using ecs::core::err;
+
+	// Uniform grid hashed into a fixed number of buckets. Each bucket stores its entities
+	// with their positions contiguously, cells sharing a bucket are told apart by their
+	// coordinates. Entity ids index a flat location table, so moves and removals are O(1).
+	class SpatialHash {
+		struct Entry {
+			Entity entity;
+			int32_t cell_x;
+			int32_t cell_y;
+			float x;
+			float y;
+		};
+
+		struct Location {
+			uint32_t bucket;
+			uint32_t slot;
+		};
+
+		static constexpr uint32_t no_bucket = UINT32_MAX;
+	private:
+		float inverse_cell_size_;
+		size_t mask_;
+		std::pmr::vector<std::pmr::vector<Entry>> buckets_;
+		// grown on demand, indexed by entity id
+		std::pmr::vector<Location> locations_;
+		size_t size_{ 0 };
+
+		int32_t cell(float coordinate) const {
+			return static_cast<int32_t>(std::floor(coordinate * inverse_cell_size_));
+		}
+
+		uint32_t bucket(int32_t cell_x, int32_t cell_y) const {
+			return static_cast<uint32_t>((static_cast<uint32_t>(cell_x) * 73856093u ^ static_cast<uint32_t>(cell_y) * 19349663u) & mask_);
+		}
+
+		void push(Entity entity, int32_t cell_x, int32_t cell_y, float x, float y) {
+			const auto index = bucket(cell_x, cell_y);
+			auto& entries = buckets_[index];
+			locations_[entity] = { index, static_cast<uint32_t>(entries.size()) };
+			entries.push_back({ entity, cell_x, cell_y, x, y });
+		}
+
+		// Swap removal, the last entry of the bucket takes the slot
+		void erase(const Location location) {
+			auto& entries = buckets_[location.bucket];
+			entries[location.slot] = entries.back();
+			locations_[entries[location.slot].entity].slot = location.slot;
+			entries.pop_back();
+		}
+
+		// Calls fn(entry) for the entries of all cells overlapping the box
+		template<typename F>
+		void visitCells(float min_x, float min_y, float max_x, float max_y, F&& fn) const {
+			const auto first_x = cell(min_x);
+			const auto last_x = cell(max_x);
+			const auto first_y = cell(min_y);
+			const auto last_y = cell(max_y);
+			for (auto cell_y = first_y; cell_y <= last_y; cell_y++) {
+				for (auto cell_x = first_x; cell_x <= last_x; cell_x++) {
+					for (const auto& entry : buckets_[bucket(cell_x, cell_y)]) {
+						if (entry.cell_x == cell_x && entry.cell_y == cell_y) {
+							fn(entry);
+						}
+					}
+				}
+			}
+		}
+	public:
+		// Cells are cell_size wide, the bucket count is rounded up to a power of two.
+		// Queries are fastest with a cell size close to the usual query radius.
+		explicit SpatialHash(float cell_size, size_t buckets = 4096, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			inverse_cell_size_(1.0f / cell_size),
+			mask_(0),
+			buckets_(resource),
+			locations_(resource) {
+			size_t count = 1;
+			while (count < buckets) {
+				count <<= 1;
+			}
+			mask_ = count - 1;
+			buckets_.resize(count);
+		}
+
+		err Insert(Entity entity, float x, float y) {
+			if (Contains(entity)) {
+				return err::already_registered;
+			}
+			if (entity >= locations_.size()) {
+				locations_.resize(entity + 1, { no_bucket, 0 });
+			}
+			push(entity, cell(x), cell(y), x, y);
+			size_++;
+			return err::ok;
+		}
+
+		// Updates the position in place while the entity stays in its cell
+		err Move(Entity entity, float x, float y) {
+			if (!Contains(entity)) {
+				return err::no_entity;
+			}
+			const auto location = locations_[entity];
+			auto& entry = buckets_[location.bucket][location.slot];
+			const auto cell_x = cell(x);
+			const auto cell_y = cell(y);
+			if (entry.cell_x == cell_x && entry.cell_y == cell_y) {
+				entry.x = x;
+				entry.y = y;
+				return err::ok;
+			}
+			erase(location);
+			push(entity, cell_x, cell_y, x, y);
+			return err::ok;
+		}
+
+		err Remove(Entity entity) {
+			if (!Contains(entity)) {
+				return err::no_entity;
+			}
+			erase(locations_[entity]);
+			locations_[entity].bucket = no_bucket;
+			size_--;
+			return err::ok;
+		}
+
+		bool Contains(Entity entity) const {
+			return entity < locations_.size() && locations_[entity].bucket != no_bucket;
+		}
+
+		size_t Size() const {
+			return size_;
+		}
+
+		void Clear() {
+			for (auto& entries : buckets_) {
+				entries.clear();
+			}
+			locations_.clear();
+			size_ = 0;
+		}
+
+		// Calls fn(entity) for every entity within radius of (x, y)
+		template<typename F>
+		void QueryRadius(float x, float y, float radius, F&& fn) const {
+			const auto squared = radius * radius;
+			visitCells(x - radius, y - radius, x + radius, y + radius, [&](const Entry& entry) {
+				const auto dx = entry.x - x;
+				const auto dy = entry.y - y;
+				if (dx * dx + dy * dy <= squared) {
+					fn(entry.entity);
+				}
+			});
+		}
+
+		// Calls fn(entity) for every entity inside the box, borders included
+		template<typename F>
+		void QueryAabb(float min_x, float min_y, float max_x, float max_y, F&& fn) const {
+			visitCells(min_x, min_y, max_x, max_y, [&](const Entry& entry) {
+				if (entry.x >= min_x && entry.x <= max_x && entry.y >= min_y && entry.y <= max_y) {
+					fn(entry.entity);
+				}
+			});
+		}
+
+		// Calls fn(entity) for every stored entity in bucket order
+		template<typename F>
+		void ForEach(F&& fn) const {
+			for (const auto& entries : buckets_) {
+				for (const auto& entry : entries) {
+					fn(entry.entity);
+				}
+			}
+		}
+	};
+}
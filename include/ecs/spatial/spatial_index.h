@@ -0,0 +1,97 @@
+#pragma once
+#include <bitset>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+
+#include <ecs/core/ecs.h>
+#include <ecs/spatial/spatial_hash.h>
+
+namespace ecs::spatial {
+	using ecs::core::Version;
+
+	// Coordinates of a position component, specialize for types without x_ and y_ members
+	template<typename T>
+	struct SpatialPosition {
+		static float X(const T& position) {
+			return position.x_;
+		}
+
+		static float Y(const T& position) {
+			return position.y_;
+		}
+	};
+
+	// Spatial hash over the Position components of a world. Update picks up the
+	// positions changed since the last call, unmoved entities are not touched.
+	// Removals are only looked for after the world's structure changed.
+	// Position needs change tracking, see ecs::core::TrackChanges.
+	template<typename Events, typename Position>
+	class SpatialIndex {
+		using World = ecs::core::EntityComponentSystem<Events>;
+		static_assert(ecs::core::TrackChanges<Position>::enabled, "The spatial index follows Position through change tracking");
+	private:
+		World& world_;
+		SpatialHash hash_;
+		Version since_{ 0 };
+		// structure revision of the world the removals were last checked at
+		size_t revision_{ std::numeric_limits<size_t>::max() };
+		std::bitset<ecs::core::MAX_ENTITY_COUNT> indexed_{};
+		std::bitset<ecs::core::MAX_ENTITY_COUNT> present_{};
+	public:
+		SpatialIndex(World& world, float cell_size, size_t buckets = 1024, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			world_(world),
+			hash_(cell_size, buckets, resource) {}
+
+		// Indexes moved and new positions and drops entities that lost their position
+		err Update() {
+			const auto tick = world_.Tick();
+			const auto error = world_.template ForEachChanged<Position>(since_, [this](Entity entity, const Position& position) {
+				const auto x = SpatialPosition<Position>::X(position);
+				const auto y = SpatialPosition<Position>::Y(position);
+				if (hash_.Move(entity, x, y) == err::no_entity) {
+					hash_.Insert(entity, x, y);
+					indexed_.set(entity);
+				}
+			});
+			if (error != err::ok) {
+				return error;
+			}
+
+			since_ = tick;
+			if (world_.StructureRevision() == revision_) {
+				return err::ok;
+			}
+
+			// removals leave no version behind, the entities still owning a position tell them
+			present_.reset();
+			world_.template ForEachComponent<Position>([this](Entity entity, const Position&) {
+				present_.set(entity);
+			});
+			if (const auto removed = indexed_ & ~present_; removed.any()) {
+				for (Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity++) {
+					if (removed[entity]) {
+						hash_.Remove(entity);
+					}
+				}
+				indexed_ &= present_;
+			}
+			revision_ = world_.StructureRevision();
+			return err::ok;
+		}
+
+		template<typename F>
+		void QueryRadius(float x, float y, float radius, F&& fn) const {
+			hash_.QueryRadius(x, y, radius, std::forward<F>(fn));
+		}
+
+		template<typename F>
+		void QueryAabb(float min_x, float min_y, float max_x, float max_y, F&& fn) const {
+			hash_.QueryAabb(min_x, min_y, max_x, max_y, std::forward<F>(fn));
+		}
+
+		const SpatialHash& Hash() const {
+			return hash_;
+		}
+	};
+}
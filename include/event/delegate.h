@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ecs::event {
+	static constexpr size_t DELEGATE_BUFFER_SIZE = 4 * sizeof(void*);
+
+	template<typename Signature, size_t BufferSize = DELEGATE_BUFFER_SIZE>
+	class Delegate;
+
+	// Type erased callable like std::function, but the callable is always stored
+	// inside the object. Callables larger than BufferSize fail to compile instead of
+	// falling back to the heap. Delegates are copyable, so are the callables.
+	template<typename R, typename... Args, size_t BufferSize>
+	class Delegate<R(Args...), BufferSize> {
+		enum class op { copy, move, destroy };
+
+		using Invoker = R(*)(void*, Args&&...);
+		using Manager = void(*)(op, void*, void*);
+	private:
+		alignas(std::max_align_t) unsigned char buffer_[BufferSize];
+		Invoker invoke_{ nullptr };
+		Manager manage_{ nullptr };
+
+		template<typename F>
+		static R invokeCallable(void* callable, Args&&... args) {
+			return (*static_cast<F*>(callable))(std::forward<Args>(args)...);
+		}
+
+		template<typename F>
+		static void manageCallable(op operation, void* dst, void* src) {
+			switch (operation) {
+			case op::copy:
+				new (dst) F(*static_cast<const F*>(src));
+				break;
+			case op::move:
+				new (dst) F(std::move(*static_cast<F*>(src)));
+				break;
+			case op::destroy:
+				static_cast<F*>(dst)->~F();
+				break;
+			}
+		}
+
+		void reset() {
+			if (manage_) {
+				manage_(op::destroy, buffer_, nullptr);
+			}
+			invoke_ = nullptr;
+			manage_ = nullptr;
+		}
+	public:
+		Delegate() = default;
+
+		template<typename F, typename Callable = std::decay_t<F>,
+			typename = std::enable_if_t<!std::is_same_v<Callable, Delegate> && std::is_invocable_r_v<R, Callable&, Args...>>>
+		Delegate(F&& callable) {
+			static_assert(sizeof(Callable) <= BufferSize, "Callable does not fit into the delegate buffer");
+			static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is over-aligned");
+			static_assert(std::is_copy_constructible_v<Callable>, "Delegates are copyable, move-only callables are not supported");
+
+			new (buffer_) Callable(std::forward<F>(callable));
+			invoke_ = &invokeCallable<Callable>;
+			manage_ = &manageCallable<Callable>;
+		}
+
+		Delegate(const Delegate& other) : invoke_(other.invoke_), manage_(other.manage_) {
+			if (manage_) {
+				manage_(op::copy, buffer_, const_cast<unsigned char*>(other.buffer_));
+			}
+		}
+
+		Delegate(Delegate&& other) noexcept : invoke_(other.invoke_), manage_(other.manage_) {
+			if (manage_) {
+				manage_(op::move, buffer_, other.buffer_);
+			}
+		}
+
+		Delegate& operator=(const Delegate& other) {
+			if (this != &other) {
+				reset();
+				if (other.manage_) {
+					other.manage_(op::copy, buffer_, const_cast<unsigned char*>(other.buffer_));
+				}
+				invoke_ = other.invoke_;
+				manage_ = other.manage_;
+			}
+			return *this;
+		}
+
+		Delegate& operator=(Delegate&& other) noexcept {
+			if (this != &other) {
+				reset();
+				if (other.manage_) {
+					other.manage_(op::move, buffer_, other.buffer_);
+				}
+				invoke_ = other.invoke_;
+				manage_ = other.manage_;
+			}
+			return *this;
+		}
+
+		~Delegate() {
+			reset();
+		}
+
+		// Throws std::bad_function_call when empty, like std::function
+		R operator()(Args... args) const {
+			if (!invoke_) {
+				throw std::bad_function_call();
+			}
+			return invoke_(const_cast<unsigned char*>(buffer_), std::forward<Args>(args)...);
+		}
+
+		explicit operator bool() const {
+			return invoke_ != nullptr;
+		}
+	};
+}
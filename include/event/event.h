@@ -1,5 +1,6 @@
 #pragma once
 #include <any>
+#include <vector>
 
 #include <ecs/core/types.h>
 
@@ -39,6 +40,13 @@ namespace ecs::event {
 	public:
 		virtual ~IObserver() {}
 		virtual void Notify(const Message& message) = 0;
+
+		// Called with all messages posted to one receiver, override to handle them at once
+		virtual void NotifyBatch(const std::vector<Message>& messages) {
+			for (const auto& message : messages) {
+				Notify(message);
+			}
+		}
 	};
 
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -8,13 +9,50 @@
 namespace ecs::event {
 	class Communicator {
 		using ObserverContainer = std::vector<std::shared_ptr<IObserver>>;
+		using MessageBatch = std::vector<Message>;
 	private:
 		ObserverContainer observers_{};
+		// observers indexed by the receiver entity they listen for
+		std::vector<ObserverContainer> routed_observers_{};
+		// posted messages indexed by receiver entity
+		std::vector<MessageBatch> pending_{};
+		std::vector<ecs::core::Entity> pending_receivers_{};
+		// swapped with the pending buffers while a flush delivers them
+		std::vector<MessageBatch> flushing_{};
+		std::vector<ecs::core::Entity> flushing_receivers_{};
+		// copy of the observers being notified, they may subscribe or unsubscribe meanwhile
+		ObserverContainer notifying_{};
+
+		template<typename F>
+		void notify(const ObserverContainer& observers, F&& fn) {
+			// a nested notify finds notifying_ taken and uses its own copy
+			ObserverContainer notifying;
+			notifying.swap(notifying_);
+			notifying.assign(observers.begin(), observers.end());
+			for (const auto& observer : notifying) {
+				fn(*observer);
+			}
+			notifying.clear();
+			notifying.swap(notifying_);
+		}
 	public:
 		bool AddObserver(std::shared_ptr<IObserver> observer);
 		bool RemoveObserver(std::shared_ptr<IObserver> observer);
 		bool HasObserver(std::shared_ptr<IObserver> observer);
 		void Broadcast(const Message& message);
+
+		// Routed mode: observers only receive messages addressed to their entity
+		bool AddObserver(ecs::core::Entity receiver, std::shared_ptr<IObserver> observer);
+		bool RemoveObserver(ecs::core::Entity receiver, std::shared_ptr<IObserver> observer);
+		bool HasObserver(ecs::core::Entity receiver, std::shared_ptr<IObserver> observer) const;
+		// Delivers the message to the observers of its receiver
+		void Send(const Message& message);
+		// Buffers the message until Flush
+		void Post(Message message);
+		// Delivers all posted messages as one batch per receiver. Messages posted
+		// by the observers meanwhile are kept for the next flush.
+		void Flush();
+		size_t Pending() const;
 	};
 
 	template<typename Event>
@@ -22,6 +60,9 @@ namespace ecs::event {
 		using Subscriptions = std::unordered_map<Event, Communicator>;
 	private:
 		Subscriptions subscriptions_;
+		// events with posted messages, in order of their first post
+		std::vector<Event> pending_events_;
+		std::vector<Event> flushing_events_;
 
 	public:
 
@@ -36,5 +77,34 @@ namespace ecs::event {
 		void Dispatch(Event evnt, const Message& message) {
 			subscriptions_[evnt].Broadcast(message);
 		}
+
+		bool Subscribe(Event evnt, ecs::core::Entity receiver, std::shared_ptr<IObserver> observer) {
+			return subscriptions_[evnt].AddObserver(receiver, observer);
+		}
+
+		bool Unsubscribe(Event evnt, ecs::core::Entity receiver, std::shared_ptr<IObserver> observer) {
+			return subscriptions_[evnt].RemoveObserver(receiver, observer);
+		}
+
+		void Send(Event evnt, const Message& message) {
+			subscriptions_[evnt].Send(message);
+		}
+
+		void Post(Event evnt, Message message) {
+			if (std::find(pending_events_.begin(), pending_events_.end(), evnt) == pending_events_.end()) {
+				pending_events_.push_back(evnt);
+			}
+			subscriptions_[evnt].Post(std::move(message));
+		}
+
+		// Observers may subscribe or post while being notified, the map is not iterated
+		// and messages posted to an event that was already flushed wait for the next flush
+		void Flush() {
+			flushing_events_.swap(pending_events_);
+			for (const auto evnt : flushing_events_) {
+				subscriptions_[evnt].Flush();
+			}
+			flushing_events_.clear();
+		}
 	};
 }
\ No newline at end of file
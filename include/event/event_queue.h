@@ -1,5 +1,7 @@
 #pragma once
 #include <queue>
+#include <deque>
+#include <memory_resource>
 
 #include <ecs/core/types.h>
 
@@ -7,8 +9,11 @@ namespace ecs::event {
 	template<typename Event>
 	class EventQueue {
 	private:
-		std::queue<Event> queue_{};
+		std::queue<Event, std::pmr::deque<Event>> queue_;
 	public:
+		explicit EventQueue(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			queue_(std::pmr::deque<Event>(resource)) {}
+
 		void Enqueue(Event evnt) {
 			queue_.push(evnt);
 		}
@@ -1,8 +1,9 @@
 #pragma once
 #include <vector>
 #include <any>
-#include <functional>
-#include <unordered_map>
+#include <utility>
+
+#include <event/delegate.h>
 
 namespace ecs::event {
 	
@@ -34,36 +35,58 @@ namespace ecs::event {
 		}
 	};
 
+	// Dispatches events to callbacks. Listeners of one id are kept in a contiguous
+	// vector, the vectors itself are indexed by the numeric value of the id.
 	template<typename EventId>
 	class EventHandler {
-		using handlerArray = std::vector<std::function<void(Event&)>>;
+		using Callback = Delegate<void(Event<EventId>&)>;
+		using HandlerArray = std::vector<Callback>;
 	private:
-		std::unordered_map<EventId, handlerArray> listeners_;
+		std::vector<HandlerArray> listeners_{};
+
+		static size_t toIndex(EventId id) {
+			return static_cast<size_t>(id);
+		}
 	public:
 
-		void Subscribe(EventId id, std::function<void(Event&)> callback) {
-			if (auto listener = listeners_.find(id); listener == listeners_.end()) {
-				handlerArray handler;
-				handler.push_back(callback);
-				listeners_[id] = handler;
+		template<typename F>
+		void Subscribe(EventId id, F&& callback) {
+			const auto index = toIndex(id);
+
+			if (index >= listeners_.size()) {
+				listeners_.resize(index + 1);
 			}
-			else {
-				listener->second.push_back(callback);
+			listeners_[index].emplace_back(std::forward<F>(callback));
+		}
+
+		void Unsubscribe(EventId id) {
+			if (const auto index = toIndex(id); index < listeners_.size()) {
+				listeners_[index].clear();
 			}
 		}
 
-		void Publish(Event& evnt) {
-			const auto id = evnt.GetId();
+		void Publish(Event<EventId>& evnt) const {
+			const auto index = toIndex(evnt.GetId());
 
-			for (const auto& listener : listeners_.at(id)) {
+			if (index >= listeners_.size()) {
+				return;
+			}
+			for (const auto& listener : listeners_[index]) {
 				listener(evnt);
 			}
 		}
 
-		void Publish(EventId id) {
-			Event evnt{ id };
+		void Publish(EventId id) const {
+			Event<EventId> evnt{ id };
 
 			Publish(evnt);
 		}
+
+		size_t Listeners(EventId id) const {
+			if (const auto index = toIndex(id); index < listeners_.size()) {
+				return listeners_[index].size();
+			}
+			return 0;
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <logging/log_record.h>
+
+namespace logging {
+	static constexpr size_t LOG_RING_CAPACITY = 1024;
+
+	// Single producer single consumer ring of log records, one per logging thread
+	class LogRingBuffer {
+	private:
+		std::array<LogRecord, LOG_RING_CAPACITY> records_;
+		alignas(64) std::atomic<size_t> head_{ 0 };
+		alignas(64) std::atomic<size_t> tail_{ 0 };
+	public:
+		// Returns false if the ring is full
+		bool Push(const LogRecord& record) {
+			const auto head = head_.load(std::memory_order_relaxed);
+			if (head - tail_.load(std::memory_order_acquire) == LOG_RING_CAPACITY) {
+				return false;
+			}
+			records_[head % LOG_RING_CAPACITY] = record;
+			head_.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Calls fn for every pending record, returns the number of records
+		template<typename F>
+		size_t Drain(F&& fn) {
+			const auto tail = tail_.load(std::memory_order_relaxed);
+			const auto head = head_.load(std::memory_order_acquire);
+			for (auto index = tail; index != head; index++) {
+				fn(records_[index % LOG_RING_CAPACITY]);
+			}
+			tail_.store(head, std::memory_order_release);
+			return head - tail;
+		}
+
+		bool Empty() const {
+			return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+		}
+	};
+
+	// Moves log output to a background thread. Logging threads copy records into
+	// their own ring buffer, the writer formats them and writes them in batches.
+	class AsyncLogger {
+		using Buffers = std::vector<std::shared_ptr<LogRingBuffer>>;
+	private:
+		static inline std::mutex buffers_mutex_{};
+		static inline Buffers buffers_{};
+		static inline std::atomic<bool> running_{ false };
+		static inline std::atomic<size_t> dropped_{ 0 };
+		static inline std::thread writer_{};
+		static inline std::ostream* stream_{ nullptr };
+		static inline std::ofstream ostream_{};
+
+		static LogRingBuffer& threadBuffer() {
+			thread_local std::shared_ptr<LogRingBuffer> buffer = []() {
+				auto created = std::make_shared<LogRingBuffer>();
+				std::lock_guard<std::mutex> lock(buffers_mutex_);
+				buffers_.push_back(created);
+				return created;
+			}();
+			return *buffer;
+		}
+
+		// Writes everything pending with one write call, returns the number of written records
+		static size_t writeBatch(std::ostringstream& batch) {
+			Buffers buffers;
+			{
+				std::lock_guard<std::mutex> lock(buffers_mutex_);
+				buffers = buffers_;
+			}
+
+			batch.str({});
+			size_t written = 0;
+			for (const auto& buffer : buffers) {
+				written += buffer->Drain([&batch](const LogRecord& record) {
+					FormatRecord(batch, record);
+				});
+			}
+			if (written) {
+				const auto text = batch.str();
+				stream_->write(text.data(), text.size());
+				stream_->flush();
+			}
+			buffers.clear();
+
+			// forget buffers of finished threads
+			std::lock_guard<std::mutex> lock(buffers_mutex_);
+			for (auto it = buffers_.begin(); it != buffers_.end();) {
+				if (it->use_count() == 1 && (*it)->Empty()) {
+					it = buffers_.erase(it);
+				}
+				else {
+					++it;
+				}
+			}
+			return written;
+		}
+
+		static void run() {
+			std::ostringstream batch;
+			while (running_.load(std::memory_order_acquire)) {
+				if (writeBatch(batch) == 0) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+			}
+			writeBatch(batch);
+		}
+
+		// Joins the writer before the static members are destroyed
+		struct Shutdown {
+			~Shutdown() {
+				Stop();
+			}
+		};
+		static inline Shutdown shutdown_{};
+	public:
+		static void Start(std::ostream& stream) {
+			Stop();
+			stream_ = &stream;
+			running_.store(true, std::memory_order_release);
+			writer_ = std::thread(&AsyncLogger::run);
+		}
+
+		static void Start(const std::string& filename) {
+			Stop();
+			if (ostream_.is_open()) {
+				ostream_.close();
+			}
+			ostream_.open(filename, std::ios::out | std::ios::app);
+			Start(ostream_);
+		}
+
+		// Writes all pending records and joins the writer thread
+		static void Stop() {
+			if (running_.exchange(false) && writer_.joinable()) {
+				writer_.join();
+			}
+		}
+
+		static bool Running() {
+			return running_.load(std::memory_order_acquire);
+		}
+
+		// Returns false and counts the record as dropped if the thread's ring is full
+		static bool Push(const LogRecord& record) {
+			if (threadBuffer().Push(record)) {
+				return true;
+			}
+			dropped_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		static size_t Dropped() {
+			return dropped_.load(std::memory_order_relaxed);
+		}
+	};
+}
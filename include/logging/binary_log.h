@@ -0,0 +1,379 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <logging/logging.h>
+#include <utils/ticks.h>
+
+// Binary log file layout, all values little endian as written by the host:
+//   header:  "ECSBLOG1" u64 ticks_per_second u64 start_ticks i64 start_time_ns
+//   format:  'F' u32 id i32 level u32 line u16 size file u16 size format
+//   chunk:   'C' u32 thread u32 size records...
+//   record:  u32 id u64 ticks u8 argc (u8 type payload)...
+namespace logging {
+	using FormatId = uint32_t;
+
+	enum class BinaryArg : uint8_t { i64 = 1, u64, f64, string, character, boolean };
+
+	namespace detail {
+		static constexpr char BINARY_LOG_MAGIC[8] = { 'E', 'C', 'S', 'B', 'L', 'O', 'G', '1' };
+		static constexpr size_t BINARY_LOG_CHUNK_SIZE = 64 * 1024;
+
+		template<typename T>
+		void put(std::vector<char>& buffer, const T& value) {
+			const auto size = buffer.size();
+			buffer.resize(size + sizeof(T));
+			std::memcpy(buffer.data() + size, &value, sizeof(T));
+		}
+
+		inline void putString(std::vector<char>& buffer, const char* text, uint32_t length) {
+			put(buffer, BinaryArg::string);
+			put(buffer, length);
+			buffer.insert(buffer.end(), text, text + length);
+		}
+
+		template<typename T>
+		void putArg(std::vector<char>& buffer, const T& value) {
+			if constexpr (std::is_same_v<T, bool>) {
+				put(buffer, BinaryArg::boolean);
+				put(buffer, static_cast<uint8_t>(value));
+			}
+			else if constexpr (std::is_same_v<T, char>) {
+				put(buffer, BinaryArg::character);
+				put(buffer, value);
+			}
+			else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+				if constexpr (std::is_signed_v<T>) {
+					put(buffer, BinaryArg::i64);
+					put(buffer, static_cast<int64_t>(value));
+				}
+				else {
+					put(buffer, BinaryArg::u64);
+					put(buffer, static_cast<uint64_t>(value));
+				}
+			}
+			else if constexpr (std::is_floating_point_v<T>) {
+				put(buffer, BinaryArg::f64);
+				put(buffer, static_cast<double>(value));
+			}
+			else if constexpr (std::is_convertible_v<const T&, const char*>) {
+				const char* text = value;
+				putString(buffer, text, static_cast<uint32_t>(std::strlen(text)));
+			}
+			else {
+				static_assert(std::is_same_v<T, std::string>, "Type is not supported by the binary log");
+				putString(buffer, value.data(), static_cast<uint32_t>(value.size()));
+			}
+		}
+	}
+
+	// Writes log records as format id, tick count and raw arguments. Formatting
+	// happens offline in BinaryLogReader (tools/log_decoder).
+	class BinaryLog {
+		struct Format {
+			Loglevel level;
+			const char* file;
+			uint32_t line;
+			const char* fmt;
+		};
+
+		// Records of one thread, written to the file as one chunk
+		struct ThreadBuffer {
+			uint32_t thread{ 0 };
+			std::vector<char> data{};
+
+			ThreadBuffer(uint32_t index) : thread(index) {
+				data.reserve(detail::BINARY_LOG_CHUNK_SIZE);
+			}
+		};
+		using Buffers = std::vector<std::shared_ptr<ThreadBuffer>>;
+	private:
+		static inline std::mutex mutex_{};
+		static inline std::ofstream file_{};
+		static inline std::vector<Format> formats_{};
+		static inline Buffers buffers_{};
+		static inline uint32_t thread_counter_{ 0 };
+		static inline std::atomic<bool> open_{ false };
+
+		static void writeFormat(FormatId id, const Format& format) {
+			std::vector<char> entry;
+			detail::put(entry, 'F');
+			detail::put(entry, id);
+			detail::put(entry, static_cast<int32_t>(format.level));
+			detail::put(entry, format.line);
+			const auto file_size = static_cast<uint16_t>(std::strlen(format.file));
+			detail::put(entry, file_size);
+			entry.insert(entry.end(), format.file, format.file + file_size);
+			const auto fmt_size = static_cast<uint16_t>(std::strlen(format.fmt));
+			detail::put(entry, fmt_size);
+			entry.insert(entry.end(), format.fmt, format.fmt + fmt_size);
+			file_.write(entry.data(), entry.size());
+		}
+
+		// mutex_ must be held
+		static void writeChunk(ThreadBuffer& buffer) {
+			if (buffer.data.empty()) {
+				return;
+			}
+			if (file_.is_open()) {
+				std::vector<char> header;
+				detail::put(header, 'C');
+				detail::put(header, buffer.thread);
+				detail::put(header, static_cast<uint32_t>(buffer.data.size()));
+				file_.write(header.data(), header.size());
+				file_.write(buffer.data.data(), buffer.data.size());
+			}
+			buffer.data.clear();
+		}
+
+		static ThreadBuffer& threadBuffer() {
+			// flushes the remaining records when the thread exits
+			struct Owner {
+				std::shared_ptr<ThreadBuffer> buffer;
+				Owner() {
+					std::lock_guard<std::mutex> lock(mutex_);
+					buffer = std::make_shared<ThreadBuffer>(thread_counter_++);
+					buffers_.push_back(buffer);
+				}
+				~Owner() {
+					std::lock_guard<std::mutex> lock(mutex_);
+					writeChunk(*buffer);
+					buffers_.erase(std::find(buffers_.begin(), buffers_.end(), buffer));
+				}
+			};
+			thread_local Owner owner;
+			return *owner.buffer;
+		}
+	public:
+		static bool Open(const std::string& filename) {
+			Close();
+			std::lock_guard<std::mutex> lock(mutex_);
+			file_.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file_.is_open()) {
+				return false;
+			}
+			std::vector<char> header(std::begin(detail::BINARY_LOG_MAGIC), std::end(detail::BINARY_LOG_MAGIC));
+			detail::put(header, utils::clock::TicksPerSecond());
+			detail::put(header, utils::clock::Ticks());
+			detail::put(header, TimestampNow());
+			file_.write(header.data(), header.size());
+
+			for (FormatId id = 0; id < formats_.size(); id++) {
+				writeFormat(id, formats_[id]);
+			}
+			open_.store(true, std::memory_order_release);
+			return true;
+		}
+
+		// Writes the records of all threads, logging threads must be idle
+		static void Close() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			open_.store(false, std::memory_order_release);
+			for (const auto& buffer : buffers_) {
+				writeChunk(*buffer);
+			}
+			if (file_.is_open()) {
+				file_.close();
+			}
+		}
+
+		static bool IsOpen() {
+			return open_.load(std::memory_order_acquire);
+		}
+
+		// Registers a static format string, called once per log statement.
+		// file and fmt must outlive the log.
+		static FormatId Register(Loglevel level, const char* file, uint32_t line, const char* fmt) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			const auto id = static_cast<FormatId>(formats_.size());
+			formats_.push_back({ level, file, line, fmt });
+			if (file_.is_open()) {
+				writeFormat(id, formats_.back());
+			}
+			return id;
+		}
+
+		template<typename... Args>
+		static void Write(FormatId id, const Args&... args) {
+			auto& buffer = threadBuffer();
+
+			detail::put(buffer.data, id);
+			detail::put(buffer.data, utils::clock::Ticks());
+			detail::put(buffer.data, static_cast<uint8_t>(sizeof...(Args)));
+			(detail::putArg(buffer.data, args), ...);
+
+			if (buffer.data.size() >= detail::BINARY_LOG_CHUNK_SIZE) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				writeChunk(buffer);
+			}
+		}
+	};
+
+	// Turns a binary log back into the text format of Logger
+	class BinaryLogReader {
+		struct Format {
+			Loglevel level{ Loglevel::LEVEL_ALL };
+			uint32_t line{ 0 };
+			std::string file{};
+			std::string fmt{};
+		};
+		struct Line {
+			uint64_t ticks;
+			std::string text;
+		};
+	private:
+		std::vector<Format> formats_{};
+		uint64_t ticks_per_second_{ 1 };
+		uint64_t start_ticks_{ 0 };
+		int64_t start_time_ns_{ 0 };
+
+		template<typename T>
+		static bool get(const char*& it, const char* end, T& value) {
+			if (static_cast<size_t>(end - it) < sizeof(T)) return false;
+			std::memcpy(&value, it, sizeof(T));
+			it += sizeof(T);
+			return true;
+		}
+
+		static bool getString(const char*& it, const char* end, std::string& value, size_t size) {
+			if (static_cast<size_t>(end - it) < size) return false;
+			value.assign(it, size);
+			it += size;
+			return true;
+		}
+
+		static bool readArg(const char*& it, const char* end, std::string& value) {
+			BinaryArg type;
+			if (!get(it, end, type)) return false;
+
+			std::ostringstream stream;
+			switch (type) {
+			case BinaryArg::i64: { int64_t v; if (!get(it, end, v)) return false; stream << v; break; }
+			case BinaryArg::u64: { uint64_t v; if (!get(it, end, v)) return false; stream << v; break; }
+			case BinaryArg::f64: { double v; if (!get(it, end, v)) return false; stream << v; break; }
+			case BinaryArg::character: { char v; if (!get(it, end, v)) return false; stream << v; break; }
+			case BinaryArg::boolean: { uint8_t v; if (!get(it, end, v)) return false; stream << (v != 0); break; }
+			case BinaryArg::string: {
+				uint32_t size;
+				return get(it, end, size) && getString(it, end, value, size);
+			}
+			default:
+				return false;
+			}
+			value = stream.str();
+			return true;
+		}
+
+		// Substitutes "{}" placeholders like logging::Format
+		static std::string substitute(const std::string& fmt, const std::vector<std::string>& args) {
+			std::string text;
+			size_t arg = 0;
+			for (size_t index = 0; index < fmt.size(); index++) {
+				const bool has_next = index + 1 < fmt.size();
+				if (has_next && fmt[index] == '{' && fmt[index + 1] == '}' && arg < args.size()) {
+					text += args[arg++];
+					index++;
+				}
+				else if (has_next && (fmt[index] == '{' || fmt[index] == '}') && fmt[index + 1] == fmt[index]) {
+					text += fmt[index++];
+				}
+				else {
+					text += fmt[index];
+				}
+			}
+			return text;
+		}
+
+		bool readChunk(const char* it, const char* end, uint32_t thread, std::vector<Line>& lines) const {
+			while (it != end) {
+				FormatId id;
+				uint64_t ticks;
+				uint8_t argc;
+				if (!get(it, end, id) || !get(it, end, ticks) || !get(it, end, argc)) return false;
+				if (id >= formats_.size()) return false;
+
+				std::vector<std::string> args(argc);
+				for (auto& arg : args) {
+					if (!readArg(it, end, arg)) return false;
+				}
+
+				const auto& format = formats_[id];
+				const auto elapsed_ns = static_cast<int64_t>(static_cast<int64_t>(ticks - start_ticks_) * 1.0e9 / ticks_per_second_);
+				std::ostringstream stream;
+				FormatPrefix(stream, format.level, start_time_ns_ + elapsed_ns, thread, format.file.c_str(), format.line);
+				stream << substitute(format.fmt, args) << '\n';
+				lines.push_back({ ticks, stream.str() });
+			}
+			return true;
+		}
+	public:
+		// Writes all records ordered by time, returns false for malformed input
+		bool Decode(std::istream& input, std::ostream& output) {
+			const std::string data{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+			const char* it = data.data();
+			const char* end = it + data.size();
+
+			if (data.size() < sizeof(detail::BINARY_LOG_MAGIC) || std::memcmp(it, detail::BINARY_LOG_MAGIC, sizeof(detail::BINARY_LOG_MAGIC)) != 0) {
+				return false;
+			}
+			it += sizeof(detail::BINARY_LOG_MAGIC);
+			if (!get(it, end, ticks_per_second_) || !get(it, end, start_ticks_) || !get(it, end, start_time_ns_) || ticks_per_second_ == 0) {
+				return false;
+			}
+
+			std::vector<Line> lines;
+			while (it != end) {
+				char kind;
+				get(it, end, kind);
+				if (kind == 'F') {
+					FormatId id;
+					int32_t level;
+					Format format;
+					uint16_t file_size, fmt_size;
+					if (!get(it, end, id) || !get(it, end, level) || !get(it, end, format.line)) return false;
+					if (!get(it, end, file_size) || !getString(it, end, format.file, file_size)) return false;
+					if (!get(it, end, fmt_size) || !getString(it, end, format.fmt, fmt_size)) return false;
+					format.level = static_cast<Loglevel>(level);
+					if (id >= formats_.size()) {
+						formats_.resize(id + 1);
+					}
+					formats_[id] = format;
+				}
+				else if (kind == 'C') {
+					uint32_t thread, size;
+					if (!get(it, end, thread) || !get(it, end, size) || static_cast<size_t>(end - it) < size) return false;
+					if (!readChunk(it, it + size, thread, lines)) return false;
+					it += size;
+				}
+				else {
+					return false;
+				}
+			}
+
+			std::stable_sort(lines.begin(), lines.end(), [](const Line& a, const Line& b) {
+				return a.ticks < b.ticks;
+			});
+			for (const auto& line : lines) {
+				output << line.text;
+			}
+			return true;
+		}
+	};
+}
+
+// Binary counterpart of lLogf, arguments must be arithmetic or strings
+#define lLogb(level, fmt, ...) if constexpr (static_cast<int>(level) < LOG_MIN_LEVEL);else if(level < logging::Logger::GetLogLevel() || !logging::BinaryLog::IsOpen());else { \
+	static const logging::FormatId lLogbFormat = logging::BinaryLog::Register(level, lFile, __LINE__, fmt); \
+	logging::BinaryLog::Write(lLogbFormat, ##__VA_ARGS__); }
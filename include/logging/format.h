@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+
+namespace logging {
+	namespace detail {
+		// Writes fmt up to the next "{}" placeholder, returns the rest behind it or nullptr at the end
+		inline const char* writeUntilPlaceholder(std::ostream& stream, const char* fmt) {
+			const char* it = fmt;
+			while (*it != '\0') {
+				if (it[0] == '{' && it[1] == '{') {
+					stream.write(fmt, it - fmt + 1);
+					fmt = it += 2;
+				}
+				else if (it[0] == '}' && it[1] == '}') {
+					stream.write(fmt, it - fmt + 1);
+					fmt = it += 2;
+				}
+				else if (it[0] == '{' && it[1] == '}') {
+					stream.write(fmt, it - fmt);
+					return it + 2;
+				}
+				else {
+					it++;
+				}
+			}
+			stream.write(fmt, it - fmt);
+			return nullptr;
+		}
+
+		inline void format(std::ostream& stream, const char* fmt) {
+			while (fmt) {
+				fmt = writeUntilPlaceholder(stream, fmt);
+				// surplus placeholders are printed as is
+				if (fmt) stream << "{}";
+			}
+		}
+
+		template<typename Arg, typename... Args>
+		void format(std::ostream& stream, const char* fmt, const Arg& arg, const Args&... args) {
+			fmt = writeUntilPlaceholder(stream, fmt);
+			if (!fmt) {
+				return;
+			}
+			stream << arg;
+			format(stream, fmt, args...);
+		}
+	}
+
+	// Minimal "{}" formatter, every placeholder is replaced by the next argument's operator<<
+	template<typename... Args>
+	void Format(std::ostream& stream, const char* fmt, const Args&... args) {
+		detail::format(stream, fmt, args...);
+	}
+
+	// Offset of the file name behind the last path separator, usable at compile time
+	constexpr size_t BasenameOffset(const char* path) {
+		size_t offset = 0;
+		for (size_t index = 0; path[index] != '\0'; index++) {
+			if (path[index] == '/' || path[index] == '\\') {
+				offset = index + 1;
+			}
+		}
+		return offset;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace logging {
+	enum class Loglevel : int { LEVEL_ALL = 0, LEVEL_INFO = 10, LEVEL_DEBUG = 30, LEVEL_WARN = 50, LEVEL_ERR = 70 };
+
+	static constexpr size_t LOG_RECORD_SIZE = 256;
+
+	// Raw log line as handed from the logging thread to the writer
+	struct LogRecord {
+		int64_t timestamp_ns{ 0 };
+		std::thread::id thread{};
+		const char* file{ nullptr };
+		uint32_t line{ 0 };
+		Loglevel level{ Loglevel::LEVEL_ALL };
+		uint16_t length{ 0 };
+		char message[LOG_RECORD_SIZE - sizeof(int64_t) - sizeof(std::thread::id) - sizeof(const char*) - 2 * sizeof(uint32_t) - sizeof(uint16_t)];
+
+		// Copies the message, longer messages are truncated
+		void SetMessage(const char* text, size_t size) {
+			length = static_cast<uint16_t>(size < sizeof(message) ? size : sizeof(message));
+			std::memcpy(message, text, length);
+		}
+	};
+
+	constexpr const char* ConvertLevel(Loglevel level) {
+		switch (level) {
+		case Loglevel::LEVEL_DEBUG:
+			return "[Debug]";
+		case Loglevel::LEVEL_INFO:
+			return "[Info]";
+		case Loglevel::LEVEL_WARN:
+			return "[Warn]";
+		case Loglevel::LEVEL_ERR:
+			return "[Error]";
+		default:
+			return "[All]";
+		}
+	}
+
+	inline int64_t TimestampNow() {
+		const auto now = std::chrono::system_clock::now().time_since_epoch();
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+	}
+
+	// Thread safe replacement for std::localtime
+	inline std::tm LocalTime(std::time_t time) {
+		std::tm local{};
+#ifdef _WIN32
+		localtime_s(&local, &time);
+#else
+		localtime_r(&time, &local);
+#endif
+		return local;
+	}
+
+	// Writes "<date> <time>.<ms> <thread> [Level] file:line: "
+	template<typename ThreadId>
+	void FormatPrefix(std::ostream& stream, Loglevel level, int64_t timestamp_ns, ThreadId thread, const char* file, uint32_t line) {
+		const auto ms = timestamp_ns / 1000000;
+		const std::time_t t = static_cast<std::time_t>(ms / 1000);
+		const std::tm local = LocalTime(t);
+
+		stream << std::put_time(&local, "%F %T") << "." << ms % 1000 << " " << thread
+			<< " " << ConvertLevel(level) << " " << file << ":" << line << ": ";
+	}
+
+	inline void FormatRecord(std::ostream& stream, const LogRecord& record) {
+		FormatPrefix(stream, record.level, record.timestamp_ns, record.thread, record.file, record.line);
+		stream.write(record.message, record.length);
+		stream << '\n';
+	}
+}
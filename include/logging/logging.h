@@ -7,46 +7,28 @@
 #include <sstream>
 #include <iomanip>
 #include <fstream>
-#include <filesystem>
+#include <mutex>
+#include <type_traits>
 
+#include <logging/log_record.h>
+#include <logging/async_logger.h>
+#include <logging/format.h>
+
+// Log statements below this level are removed at compile time
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
 
-namespace logging {
-	enum class Loglevel : int { LEVEL_ALL = 0, LEVEL_INFO = 10, LEVEL_DEBUG = 30, LEVEL_WARN = 50, LEVEL_ERR = 70 };
 
+namespace logging {
 	class Logger {
 		static inline Loglevel log_level_ = Loglevel::LEVEL_ALL;
 	private:
 		static inline std::ostream* stream_ = &std::cout;
 		static inline std::ofstream ostream_;
+		static inline std::mutex stream_mutex_;
 		std::stringstream sstream_;
-
-		constexpr const char* convertLevel(Loglevel level) const {
-			switch (level) {
-			case Loglevel::LEVEL_DEBUG:
-				return "[Debug]";
-			case Loglevel::LEVEL_INFO:
-				return "[Info]";
-			case Loglevel::LEVEL_WARN:
-				return "[Warn]";
-			case Loglevel::LEVEL_ERR:
-				return "[Error]";
-			default:
-				return "[All]";
-			}
-		}
-
-		std::string formatLogging(const Loglevel level, const std::string& file, const int line) {
-			std::chrono::system_clock::time_point p = std::chrono::system_clock::now();
-			std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(p.time_since_epoch());
-			size_t ms_frac = ms.count() % 1000;
-			std::chrono::seconds s = std::chrono::duration_cast<std::chrono::seconds>(ms);
-			std::time_t t = s.count();
-
-			std::stringstream ss{};
-			ss << std::put_time(std::localtime(&t), "%F %T") << "." << ms_frac << " " << std::this_thread::get_id()
-				<< " " <<  convertLevel(level) << " " << std::filesystem::path(file).filename().string() << ":" << line << ": ";
-			return ss.str();
-		}
+		LogRecord record_;
 
 	public:
 		Logger() :
@@ -54,14 +36,33 @@ namespace logging {
 		{}
 
 		~Logger() {
-			*stream_ << sstream_.str() << std::endl << std::flush;
+			const auto message = sstream_.str();
+
+			if (AsyncLogger::Running()) {
+				record_.SetMessage(message.data(), message.size());
+				AsyncLogger::Push(record_);
+				return;
+			}
+			std::lock_guard<std::mutex> lock(stream_mutex_);
+			FormatPrefix(*stream_, record_.level, record_.timestamp_ns, record_.thread, record_.file, record_.line);
+			*stream_ << message << std::endl << std::flush;
 		}
 
-		std::ostream& Get(const Loglevel level, const std::string& file, const uint32_t line) {
-			sstream_ << formatLogging(level, file, line);
+		std::ostream& Get(const Loglevel level, const char* file, const uint32_t line) {
+			record_.timestamp_ns = TimestampNow();
+			record_.thread = std::this_thread::get_id();
+			record_.file = file;
+			record_.line = line;
+			record_.level = level;
 			return sstream_;
 		} 
 
+		// Formats "{}" placeholders with args, only called for emitted records
+		template<typename... Args>
+		void Format(const Loglevel level, const char* file, const uint32_t line, const char* fmt, const Args&... args) {
+			logging::Format(Get(level, file, line), fmt, args...);
+		}
+
 		static void SetLogLevel(const Loglevel level) {
 			log_level_ = level;
 		}
@@ -78,10 +79,24 @@ namespace logging {
 			ostream_.open(filename, std::ios::out | std::ios::app);
 			stream_ = &ostream_;
 		}
+
+		// Hands all following log lines to a background writer thread
+		static void StartAsync() {
+			AsyncLogger::Start(*stream_);
+		}
+
+		static void StopAsync() {
+			AsyncLogger::Stop();
+		}
 	};
 }
 
-#define lLog(level) if(level < logging::Logger::GetLogLevel());else logging::Logger().Get(level, __FILE__, __LINE__)
+#define lFile (__FILE__ + std::integral_constant<size_t, logging::BasenameOffset(__FILE__)>::value)
+
+#define lLog(level) if constexpr (static_cast<int>(level) < LOG_MIN_LEVEL);else if(level < logging::Logger::GetLogLevel());else logging::Logger().Get(level, lFile, __LINE__)
+
+// Arguments are only evaluated when the record is emitted
+#define lLogf(level, ...) if constexpr (static_cast<int>(level) < LOG_MIN_LEVEL);else if(level < logging::Logger::GetLogLevel());else logging::Logger().Format(level, lFile, __LINE__, __VA_ARGS__)
 
 #define lAll	(logging::Loglevel::LEVEL_ALL)
 #define lDebug	(logging::Loglevel::LEVEL_DEBUG)
@@ -5,15 +5,18 @@
 
 namespace utils::clock {
 
+	// Stopwatch on the monotonic steady_clock
 	class Chrono {
+		using Clock = std::chrono::steady_clock;
 	private:
-		std::chrono::high_resolution_clock::time_point start_time_{};
-		std::chrono::high_resolution_clock::time_point stop_time_{};
+		Clock::time_point start_time_{};
+		Clock::time_point stop_time_{};
 
 	public:
 		Chrono();
 
 		utils::time_ms TimePassed() const;
+		utils::time_ns TimePassedNs() const;
 		void Start();
 		utils::time_ms Stop();
 
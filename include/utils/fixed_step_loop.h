@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+namespace utils {
+	// Game loop driver running the simulation at a fixed rate and rendering as often as possible.
+	// Render gets the interpolation alpha between the last two simulation states, rendering is
+	// paced by the display or by an optional frame cap, never by the simulation rate.
+	class FixedStepLoop {
+	public:
+		using Clock = std::chrono::steady_clock;
+	private:
+		std::chrono::nanoseconds step_;
+		size_t max_catch_up_;
+		Clock::time_point previous_{};
+		std::chrono::nanoseconds accumulator_{ 0 };
+		bool started_{ false };
+		std::atomic<bool> running_{ false };
+		uint64_t steps_{ 0 };
+		uint64_t dropped_steps_{ 0 };
+		// expected oversleep of the os, the rest of a wait is spent spinning
+		std::chrono::nanoseconds spin_threshold_{ std::chrono::milliseconds(1) };
+		// shortest time between two frames of Run, 0 renders as fast as render returns
+		std::chrono::nanoseconds frame_cap_{ 0 };
+
+		size_t catchUp() {
+			size_t steps = 0;
+			while (accumulator_ >= step_ && steps < max_catch_up_) {
+				accumulator_ -= step_;
+				steps++;
+			}
+			// drop the time we cannot catch up on instead of spiraling
+			if (accumulator_ >= step_) {
+				dropped_steps_ += accumulator_ / step_;
+				accumulator_ %= step_;
+			}
+			steps_ += steps;
+			return steps;
+		}
+	public:
+		explicit FixedStepLoop(std::chrono::nanoseconds step, size_t max_catch_up = 5);
+
+		// Runs all due simulation steps at the given time and renders once, returns the number of steps
+		template<typename Step, typename Render>
+		size_t Tick(Clock::time_point now, Step&& step, Render&& render) {
+			if (!started_) {
+				previous_ = now;
+				started_ = true;
+			}
+			accumulator_ += now - previous_;
+			previous_ = now;
+
+			const auto steps = catchUp();
+			for (size_t index = 0; index < steps; index++) {
+				step(step_);
+			}
+			render(Alpha());
+			return steps;
+		}
+
+		template<typename Step, typename Render>
+		size_t Tick(Step&& step, Render&& render) {
+			return Tick(Clock::now(), std::forward<Step>(step), std::forward<Render>(render));
+		}
+
+		// Ticks until Stop is called, rendering once per pass. Without a frame cap the passes
+		// follow render, usually blocked by vsync, so frames come at display rate. A pass that
+		// ran no step then waits for the next one, so a render that does not block cannot spin.
+		template<typename Step, typename Render>
+		void Run(Step&& step, Render&& render) {
+			running_ = true;
+			while (running_) {
+				const auto start = Clock::now();
+				const auto steps = Tick(start, step, render);
+				if (frame_cap_.count() > 0) {
+					WaitUntil(start + frame_cap_);
+				} else if (steps == 0 && running_) {
+					WaitForNextStep();
+				}
+			}
+		}
+
+		void Stop();
+		// Limits Run to one frame per frame_time, 0 removes the cap
+		void SetFrameCap(std::chrono::nanoseconds frame_time);
+		// Sleeps while due is far away and spins for the last stretch
+		void WaitUntil(Clock::time_point due);
+		void WaitForNextStep();
+		// Time until the next simulation step is due
+		std::chrono::nanoseconds TimeToNextStep() const;
+		// Progress towards the next step in [0, 1)
+		double Alpha() const;
+		std::chrono::nanoseconds StepTime() const;
+		uint64_t Steps() const;
+		uint64_t DroppedSteps() const;
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace utils {
+	// Read only memory mapping of a whole file, unmapped on destruction
+	class MappedFile {
+	private:
+		const std::byte* data_{ nullptr };
+		size_t size_{ 0 };
+#ifdef _WIN32
+		void* file_{ nullptr };
+		void* mapping_{ nullptr };
+#else
+		int file_{ -1 };
+#endif
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& filename);
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		// Maps the file, returns false if it can not be opened. Empty files are not mapped.
+		bool Open(const std::string& filename);
+		void Close();
+
+		bool IsOpen() const {
+			return data_ != nullptr;
+		}
+
+		const std::byte* Data() const {
+			return data_;
+		}
+
+		size_t Size() const {
+			return size_;
+		}
+	};
+}
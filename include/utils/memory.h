@@ -0,0 +1,117 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace utils::memory {
+	struct MemoryStats {
+		size_t allocations{ 0 };
+		size_t deallocations{ 0 };
+		size_t bytes_allocated{ 0 };
+		size_t bytes_in_use{ 0 };
+	};
+
+	// Forwards to an upstream resource and counts what passes through
+	class CountingResource : public std::pmr::memory_resource {
+	private:
+		std::pmr::memory_resource* upstream_;
+		MemoryStats stats_{};
+
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			void* memory = upstream_->allocate(bytes, alignment);
+			stats_.allocations++;
+			stats_.bytes_allocated += bytes;
+			stats_.bytes_in_use += bytes;
+			return memory;
+		}
+
+		void do_deallocate(void* memory, size_t bytes, size_t alignment) override {
+			upstream_->deallocate(memory, bytes, alignment);
+			stats_.deallocations++;
+			stats_.bytes_in_use -= bytes;
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	public:
+		explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) : upstream_(upstream) {}
+
+		const MemoryStats& Stats() const {
+			return stats_;
+		}
+	};
+
+	// Linear allocator for data that lives for one frame. Deallocation is a no-op,
+	// Reset frees everything at once and keeps the chunks for the next frame.
+	class FrameArena : public std::pmr::memory_resource {
+		struct Chunk {
+			std::byte* data;
+			size_t size;
+		};
+	private:
+		std::pmr::memory_resource* upstream_;
+		std::vector<Chunk> chunks_{};
+		size_t chunk_size_;
+		size_t chunk_{ 0 };
+		size_t offset_{ 0 };
+		size_t used_{ 0 };
+
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			while (chunk_ < chunks_.size()) {
+				auto& chunk = chunks_[chunk_];
+				const auto address = reinterpret_cast<uintptr_t>(chunk.data) + offset_;
+				const auto aligned = (address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+				const auto end = aligned - reinterpret_cast<uintptr_t>(chunk.data) + bytes;
+				if (end <= chunk.size) {
+					offset_ = end;
+					used_ += bytes;
+					return reinterpret_cast<void*>(aligned);
+				}
+				chunk_++;
+				offset_ = 0;
+			}
+			const auto size = bytes + alignment > chunk_size_ ? bytes + alignment : chunk_size_;
+			chunks_.push_back({ static_cast<std::byte*>(upstream_->allocate(size, alignof(std::max_align_t))), size });
+			return do_allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void*, size_t, size_t) override {}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	public:
+		explicit FrameArena(size_t chunk_size = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+			upstream_(upstream), chunk_size_(chunk_size) {}
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		~FrameArena() {
+			for (const auto& chunk : chunks_) {
+				upstream_->deallocate(chunk.data, chunk.size, alignof(std::max_align_t));
+			}
+		}
+
+		void Reset() {
+			chunk_ = 0;
+			offset_ = 0;
+			used_ = 0;
+		}
+
+		// Bytes handed out since the last Reset
+		size_t Used() const {
+			return used_;
+		}
+
+		size_t Capacity() const {
+			size_t capacity = 0;
+			for (const auto& chunk : chunks_) {
+				capacity += chunk.size;
+			}
+			return capacity;
+		}
+	};
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <utils/ticks.h>
+
+namespace utils::profiler {
+	static constexpr size_t PROFILER_ZONE_CAPACITY = 0x10000;
+
+	struct Zone {
+		const char* name{ nullptr };
+		uint64_t start{ 0 };
+		uint64_t end{ 0 };
+	};
+
+	// Ring of the latest zones of one thread, old zones are overwritten
+	class ZoneBuffer {
+	private:
+		std::vector<Zone> zones_;
+		size_t next_{ 0 };
+		uint32_t thread_;
+	public:
+		ZoneBuffer(uint32_t thread);
+
+		void Add(const Zone& zone) {
+			zones_[next_ % PROFILER_ZONE_CAPACITY] = zone;
+			next_++;
+		}
+
+		size_t Size() const;
+		// Returns zones from oldest to newest
+		const Zone& At(size_t index) const;
+		void Clear();
+		uint32_t Thread() const;
+	};
+
+	class Profiler {
+	private:
+		static inline std::atomic<bool> enabled_{ false };
+	public:
+		static void Enable(bool enable) {
+			enabled_.store(enable, std::memory_order_relaxed);
+		}
+
+		static bool Enabled() {
+			return enabled_.load(std::memory_order_relaxed);
+		}
+
+		// Records a finished zone on the calling thread
+		static void Record(const char* name, uint64_t start, uint64_t end);
+
+		// Writes all recorded zones in the Chrome trace event format (chrome://tracing, Perfetto).
+		// Profiled threads should be idle, e.g. between frames.
+		static void ExportChromeTrace(std::ostream& stream);
+		static bool ExportChromeTrace(const std::string& filename);
+		static size_t ZoneCount();
+		static void Clear();
+	};
+
+	// Measures the lifetime of the object, name must be a string literal
+	class ScopedZone {
+	private:
+		const char* name_;
+		uint64_t start_;
+	public:
+		explicit ScopedZone(const char* name) : name_(name), start_(Profiler::Enabled() ? utils::clock::Ticks() : 0) {}
+
+		~ScopedZone() {
+			if (start_ != 0) {
+				Profiler::Record(name_, start_, utils::clock::Ticks());
+			}
+		}
+
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+	};
+}
+
+#define ECS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ECS_PROFILE_CONCAT(a, b) ECS_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef ECS_PROFILE_DISABLED
+#define ECS_PROFILE_SCOPE(name)
+#else
+#define ECS_PROFILE_SCOPE(name) utils::profiler::ScopedZone ECS_PROFILE_CONCAT(ecs_profile_zone_, __LINE__){ name }
+#endif
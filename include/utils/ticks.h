@@ -0,0 +1,43 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define UTILS_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define UTILS_HAS_TSC 1
+#else
+#define UTILS_HAS_TSC 0
+#endif
+
+namespace utils::clock {
+	// Cheapest monotonic tick source: the time stamp counter on x86, steady_clock nanoseconds otherwise
+	inline uint64_t Ticks() {
+#if UTILS_HAS_TSC
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	// Measures Ticks() against steady_clock once, the result is cached
+	inline uint64_t TicksPerSecond() {
+#if UTILS_HAS_TSC
+		static const uint64_t ticks_per_second = []() {
+			const auto start_time = std::chrono::steady_clock::now();
+			const auto start_ticks = Ticks();
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			const auto stop_ticks = Ticks();
+			const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+			return static_cast<uint64_t>((stop_ticks - start_ticks) / elapsed);
+		}();
+		return ticks_per_second;
+#else
+		return 1000000000;
+#endif
+	}
+}
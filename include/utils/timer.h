@@ -1,9 +1,9 @@
 #pragma once
-#include <clock_chrono.h>
+#include <utils/clock_chrono.h>
 
 namespace utils {
 
-	<typename Clock>
+	template<typename Clock>
 	class Timer {
 	private:
 		bool started_{ false };
@@ -12,6 +12,7 @@ namespace utils {
 		Timer() : started_(false), clock_() {}
 
 		void Start() {
+			started_ = true;
 			clock_.Start();
 		}
 
@@ -23,6 +24,10 @@ namespace utils {
 		time_ms TimePassed() const {
 			return clock_.TimePassed();
 		}
+
+		time_ns TimePassedNs() const {
+			return clock_.TimePassedNs();
+		}
 		bool IsStarted() const {
 			return started_;
 		}
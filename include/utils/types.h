@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 
 namespace utils {
 	using time_ms = uint32_t;
+	using time_ns = uint64_t;
 }
\ No newline at end of file
@@ -1,10 +1,84 @@
+#include <bitset>
+#include <utility>
+
 #include <ecs/core/component_layout.h>
 
 namespace ecs::core {
+    namespace {
+        void saveEntities(Snapshot& snapshot, const std::pmr::vector<Entity>& entities) {
+            snapshot.Write(entities.size());
+            snapshot.Write(entities.data(), entities.size() * sizeof(Entity));
+        }
+
+        // Reads a saved entity list, every entity has to be a valid id and listed once
+        err loadEntities(SnapshotReader& reader, std::pmr::vector<Entity>& entities) {
+            size_t size = 0;
+            if (const auto error = reader.Read(size); error != err::ok) {
+                return error;
+            }
+            if (size > MAX_ENTITY_COUNT) {
+                return err::entity_limit;
+            }
+            entities.resize(size);
+            if (const auto error = reader.Read(entities.data(), size * sizeof(Entity)); error != err::ok) {
+                entities.clear();
+                return error;
+            }
+            std::bitset<MAX_ENTITY_COUNT> listed;
+            for (const auto entity : entities) {
+                if (entity >= MAX_ENTITY_COUNT) {
+                    entities.clear();
+                    return err::entity_limit;
+                }
+                if (listed[entity]) {
+                    entities.clear();
+                    return err::invalid_argument;
+                }
+                listed.set(entity);
+            }
+            return err::ok;
+        }
+
+        // Checks a saved entity list against the saved entities, returns its length
+        result<size_t> validateEntities(SnapshotReader& reader, ComponentType type, const SnapshotEntities& saved) {
+            size_t size = 0;
+            if (const auto error = reader.Read(size); error != err::ok) {
+                return {error};
+            }
+            if (size > MAX_ENTITY_COUNT) {
+                return {err::entity_limit};
+            }
+            std::bitset<MAX_ENTITY_COUNT> listed;
+            for (size_t index = 0; index < size; index++) {
+                Entity entity = 0;
+                if (const auto error = reader.Read(entity); error != err::ok) {
+                    return {error};
+                }
+                if (entity >= MAX_ENTITY_COUNT) {
+                    return {err::entity_limit};
+                }
+                // dead entities and components missing from the signature are as corrupt as duplicates
+                if (listed[entity] || !saved.Owns(entity, type)) {
+                    return {err::invalid_argument};
+                }
+                listed.set(entity);
+            }
+            return {size};
+        }
+    }
+
+    Compressor::Compressor(std::pmr::memory_resource* resource) :
+    entity_to_index_(resource),
+    index_to_entity_(resource),
+    size_(0) {}
+
     result<size_t> Compressor::Add(Entity entity) {
+        if (entity_to_index_.count(entity) != 0) {
+            return {err::already_registered};
+        }
         if (const auto new_index = size_; new_index < MAX_ENTITY_COUNT) {
             entity_to_index_[entity] = new_index;
-            index_to_entity_[new_index] = entity;
+            index_to_entity_.push_back(entity);
             size_++;
 
             return {new_index};
@@ -27,7 +101,7 @@ namespace ecs::core {
             entity_to_index_[last_entity] = index_of_removed_entity;
             index_to_entity_[index_of_removed_entity] = last_entity;
             entity_to_index_.erase(entity);
-            index_to_entity_.erase(index_of_last_entity);
+            index_to_entity_.pop_back();
             size_--;
 
             return {index_of_removed_entity};
@@ -39,4 +113,317 @@ namespace ecs::core {
         return size_;
     }
 
+    result<Entity> Compressor::EntityAt(size_t index) const {
+        if (index < size_) {
+            return {index_to_entity_[index]};
+        }
+        return {err::no_entity};
+    }
+
+    const Entity* Compressor::Entities() const {
+        return index_to_entity_.data();
+    }
+
+    void Compressor::Clear() {
+        entity_to_index_.clear();
+        index_to_entity_.clear();
+        size_ = 0;
+    }
+
+    err Compressor::Swap(size_t first, size_t second) {
+        if (first >= size_ || second >= size_) {
+            return err::invalid_argument;
+        }
+        std::swap(index_to_entity_[first], index_to_entity_[second]);
+        entity_to_index_[index_to_entity_[first]] = first;
+        entity_to_index_[index_to_entity_[second]] = second;
+        return err::ok;
+    }
+
+    void Compressor::Save(Snapshot& snapshot) const {
+        saveEntities(snapshot, index_to_entity_);
+    }
+
+    result<size_t> Compressor::Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const {
+        return validateEntities(reader, type, entities);
+    }
+
+    err Compressor::Load(SnapshotReader& reader) {
+        Clear();
+        if (const auto error = loadEntities(reader, index_to_entity_); error != err::ok) {
+            return error;
+        }
+        size_ = index_to_entity_.size();
+        entity_to_index_.reserve(size_);
+        for (size_t index = 0; index < size_; index++) {
+            entity_to_index_[index_to_entity_[index]] = index;
+        }
+        return err::ok;
+    }
+
+    Direct::Direct(std::pmr::memory_resource* resource) :
+    entities_(resource) {}
+
+    result<size_t> Direct::Add(Entity entity) {
+        if (entity >= MAX_ENTITY_COUNT) {
+            return {err::entity_limit};
+        }
+        if (present_[entity]) {
+            return {err::already_registered};
+        }
+        present_.set(entity);
+        positions_[entity] = static_cast<uint32_t>(entities_.size());
+        entities_.push_back(entity);
+        return {entity};
+    }
+
+    result<size_t> Direct::Remove(Entity entity) {
+        if (entity >= MAX_ENTITY_COUNT || !present_[entity]) {
+            return {err::no_entity};
+        }
+        const auto position = positions_[entity];
+        const auto last_entity = entities_.back();
+        entities_[position] = last_entity;
+        positions_[last_entity] = position;
+        entities_.pop_back();
+        present_.reset(entity);
+        return {entity};
+    }
+
+    size_t Direct::Size() const {
+        return entities_.size();
+    }
+
+    result<Entity> Direct::EntityAt(size_t index) const {
+        if (index < entities_.size()) {
+            return {entities_[index]};
+        }
+        return {err::no_entity};
+    }
+
+    const Entity* Direct::Entities() const {
+        return entities_.data();
+    }
+
+    void Direct::Clear() {
+        present_.reset();
+        entities_.clear();
+    }
+
+    // components sit at their entity id and can not be reordered
+    err Direct::Swap(size_t, size_t) {
+        return err::invalid_argument;
+    }
+
+    void Direct::Save(Snapshot& snapshot) const {
+        saveEntities(snapshot, entities_);
+    }
+
+    result<size_t> Direct::Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const {
+        return validateEntities(reader, type, entities);
+    }
+
+    err Direct::Load(SnapshotReader& reader) {
+        Clear();
+        if (const auto error = loadEntities(reader, entities_); error != err::ok) {
+            return error;
+        }
+        for (size_t position = 0; position < entities_.size(); position++) {
+            present_.set(entities_[position]);
+            positions_[entities_[position]] = static_cast<uint32_t>(position);
+        }
+        return err::ok;
+    }
+
+    SparseSet::SparseSet(std::pmr::memory_resource* resource) :
+    dense_(resource) {}
+
+    result<size_t> SparseSet::Add(Entity entity) {
+        if (entity >= MAX_ENTITY_COUNT || dense_.size() >= MAX_ENTITY_COUNT) {
+            return {err::entity_limit};
+        }
+        if (Get(entity).error == err::ok) {
+            return {err::already_registered};
+        }
+        sparse_[entity] = static_cast<uint32_t>(dense_.size());
+        dense_.push_back(entity);
+        return {dense_.size() - 1};
+    }
+
+    result<size_t> SparseSet::Remove(Entity entity) {
+        const auto removed = Get(entity);
+        if (removed.error != err::ok) {
+            return removed;
+        }
+        const auto last_entity = dense_.back();
+        dense_[removed.data] = last_entity;
+        sparse_[last_entity] = static_cast<uint32_t>(removed.data);
+        dense_.pop_back();
+        return removed;
+    }
+
+    size_t SparseSet::Size() const {
+        return dense_.size();
+    }
+
+    result<Entity> SparseSet::EntityAt(size_t index) const {
+        if (index < dense_.size()) {
+            return {dense_[index]};
+        }
+        return {err::no_entity};
+    }
+
+    const Entity* SparseSet::Entities() const {
+        return dense_.data();
+    }
+
+    void SparseSet::Clear() {
+        dense_.clear();
+    }
+
+    err SparseSet::Swap(size_t first, size_t second) {
+        if (first >= dense_.size() || second >= dense_.size()) {
+            return err::invalid_argument;
+        }
+        std::swap(dense_[first], dense_[second]);
+        sparse_[dense_[first]] = static_cast<uint32_t>(first);
+        sparse_[dense_[second]] = static_cast<uint32_t>(second);
+        return err::ok;
+    }
+
+    void SparseSet::Save(Snapshot& snapshot) const {
+        saveEntities(snapshot, dense_);
+    }
+
+    result<size_t> SparseSet::Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const {
+        return validateEntities(reader, type, entities);
+    }
+
+    err SparseSet::Load(SnapshotReader& reader) {
+        Clear();
+        if (const auto error = loadEntities(reader, dense_); error != err::ok) {
+            return error;
+        }
+        for (size_t index = 0; index < dense_.size(); index++) {
+            sparse_[dense_[index]] = static_cast<uint32_t>(index);
+        }
+        return err::ok;
+    }
+
+    PagedSparseSet::PagedSparseSet(std::pmr::memory_resource* resource) :
+    pages_(MAX_ENTITY_COUNT / PAGE_SIZE + 1, resource),
+    dense_(resource) {}
+
+    const uint32_t* PagedSparseSet::find(Entity entity) const {
+        if (entity >= MAX_ENTITY_COUNT) {
+            return nullptr;
+        }
+        const auto& page = pages_[entity / PAGE_SIZE];
+        if (page.empty()) {
+            return nullptr;
+        }
+        const auto* index = &page[entity % PAGE_SIZE];
+        if (*index < dense_.size() && dense_[*index] == entity) {
+            return index;
+        }
+        return nullptr;
+    }
+
+    result<size_t> PagedSparseSet::Add(Entity entity) {
+        if (entity >= MAX_ENTITY_COUNT || dense_.size() >= MAX_ENTITY_COUNT) {
+            return {err::entity_limit};
+        }
+        if (find(entity)) {
+            return {err::already_registered};
+        }
+        auto& page = pages_[entity / PAGE_SIZE];
+        if (page.empty()) {
+            page.resize(PAGE_SIZE);
+        }
+        page[entity % PAGE_SIZE] = static_cast<uint32_t>(dense_.size());
+        dense_.push_back(entity);
+        return {dense_.size() - 1};
+    }
+
+    result<size_t> PagedSparseSet::Get(Entity entity) const {
+        if (const auto* index = find(entity)) {
+            return {*index};
+        }
+        return {err::no_entity};
+    }
+
+    result<size_t> PagedSparseSet::Remove(Entity entity) {
+        const auto* found = find(entity);
+        if (!found) {
+            return {err::no_entity};
+        }
+        const size_t removed = *found;
+        const auto last_entity = dense_.back();
+        dense_[removed] = last_entity;
+        pages_[last_entity / PAGE_SIZE][last_entity % PAGE_SIZE] = static_cast<uint32_t>(removed);
+        dense_.pop_back();
+        return {removed};
+    }
+
+    size_t PagedSparseSet::Size() const {
+        return dense_.size();
+    }
+
+    result<Entity> PagedSparseSet::EntityAt(size_t index) const {
+        if (index < dense_.size()) {
+            return {dense_[index]};
+        }
+        return {err::no_entity};
+    }
+
+    const Entity* PagedSparseSet::Entities() const {
+        return dense_.data();
+    }
+
+    // pages are kept, entities usually come back
+    void PagedSparseSet::Clear() {
+        dense_.clear();
+    }
+
+    err PagedSparseSet::Swap(size_t first, size_t second) {
+        if (first >= dense_.size() || second >= dense_.size()) {
+            return err::invalid_argument;
+        }
+        std::swap(dense_[first], dense_[second]);
+        pages_[dense_[first] / PAGE_SIZE][dense_[first] % PAGE_SIZE] = static_cast<uint32_t>(first);
+        pages_[dense_[second] / PAGE_SIZE][dense_[second] % PAGE_SIZE] = static_cast<uint32_t>(second);
+        return err::ok;
+    }
+
+    void PagedSparseSet::Save(Snapshot& snapshot) const {
+        saveEntities(snapshot, dense_);
+    }
+
+    result<size_t> PagedSparseSet::Validate(SnapshotReader& reader, ComponentType type, const SnapshotEntities& entities) const {
+        return validateEntities(reader, type, entities);
+    }
+
+    err PagedSparseSet::Load(SnapshotReader& reader) {
+        Clear();
+        if (const auto error = loadEntities(reader, dense_); error != err::ok) {
+            return error;
+        }
+        for (size_t index = 0; index < dense_.size(); index++) {
+            auto& page = pages_[dense_[index] / PAGE_SIZE];
+            if (page.empty()) {
+                page.resize(PAGE_SIZE);
+            }
+            page[dense_[index] % PAGE_SIZE] = static_cast<uint32_t>(index);
+        }
+        return err::ok;
+    }
+
+    size_t PagedSparseSet::Pages() const {
+        size_t pages = 0;
+        for (const auto& page : pages_) {
+            pages += page.empty() ? 0 : 1;
+        }
+        return pages;
+    }
+
 }
\ No newline at end of file
@@ -4,31 +4,56 @@
 
 
 namespace ecs::core {
-    EntityManager::EntityManager(size_t max_entity_count) :
-    available_entities_(),
+    EntityManager::EntityManager(size_t max_entity_count, std::pmr::memory_resource* resource) :
+    available_entities_(resource),
     living_entities_(),
     signatures_(),
     entity_count_(0) {
         for (Entity entity = 0; entity < (max_entity_count-1 > MAX_ENTITY_COUNT ? MAX_ENTITY_COUNT : max_entity_count); entity++) {
-            available_entities_.push(entity);
+            available_entities_.push_back(entity);
         }
     }
 
+    err EntityManager::entityExist(Entity entity) const {
+        if (entity < MAX_ENTITY_COUNT && living_entities_[entity]) {
+            return err::ok;
+        }
+        return err::no_entity;
+    }
+
     result<Entity> EntityManager::CreateEntity() {
         if (available_entities_.empty()) {
             return result<Entity>({}, err::no_entity);
         }
         Entity id = available_entities_.front();
-        living_entities_.insert(id);
-        available_entities_.pop();
+        living_entities_.set(id);
+        available_entities_.pop_front();
         entity_count_++;
 
         return result<Entity>(id, err::ok);
     }
 
+    err EntityManager::CreateEntities(size_t count, Signature signature, std::vector<Entity>& entities) {
+        if (count > available_entities_.size()) {
+            return err::entity_limit;
+        }
+        entities.reserve(entities.size() + count);
+        for (size_t created = 0; created < count; created++) {
+            const Entity id = available_entities_[created];
+            living_entities_.set(id);
+            signatures_[id] = signature;
+            entities.push_back(id);
+        }
+        available_entities_.erase(available_entities_.begin(), available_entities_.begin() + static_cast<std::ptrdiff_t>(count));
+        entity_count_ += count;
+
+        return err::ok;
+    }
+
     err EntityManager::DestroyEntity(Entity entity) {
-        if(const auto removed = living_entities_.erase(entity); removed) {
-            available_entities_.push(entity);
+        if(entityExist(entity) == err::ok) {
+            living_entities_.reset(entity);
+            available_entities_.push_back(entity);
             signatures_[entity].reset();
             --entity_count_;
 
@@ -39,7 +64,7 @@ namespace ecs::core {
     }
 
     err EntityManager::SetSignature(Entity entity, Signature signature) {
-        if(const auto found = living_entities_.find(entity); found != living_entities_.end()) {
+        if(entityExist(entity) == err::ok) {
             signatures_[entity] = signature;
 
             return err::ok;
@@ -48,17 +73,83 @@ namespace ecs::core {
     }
 
     result<Signature> EntityManager::GetSignature(Entity entity) const {
-        if(const auto found = living_entities_.find(entity); found != living_entities_.end()) {
+        if(entityExist(entity) == err::ok) {
             return result<Signature>(signatures_[entity]);
         }
         return result<Signature>({}, err::no_signature);
     }
 
     size_t EntityManager::Count() const {
-        return living_entities_.size();
+        return entity_count_;
     }
 
     bool EntityManager::Empty() const {
         return available_entities_.empty();
     }
+
+    void EntityManager::Save(Snapshot& snapshot) const {
+        static_assert(std::is_trivially_copyable_v<Signature>, "Signatures are saved as one raw block");
+        snapshot.Write(living_entities_);
+        snapshot.Write(available_entities_.size());
+        for (const auto entity : available_entities_) {
+            snapshot.Write(entity);
+        }
+        snapshot.Write(signatures_.data(), sizeof(signatures_));
+    }
+
+    err EntityManager::Validate(SnapshotReader& reader, SnapshotEntities* entities) {
+        std::bitset<MAX_ENTITY_COUNT> living;
+        if (const auto error = reader.Read(living); error != err::ok) {
+            return error;
+        }
+
+        size_t available = 0;
+        if (const auto error = reader.Read(available); error != err::ok) {
+            return error;
+        }
+        if (available > MAX_ENTITY_COUNT) {
+            return err::entity_limit;
+        }
+        // free ids are unique and not alive
+        std::bitset<MAX_ENTITY_COUNT> listed;
+        for (size_t index = 0; index < available; index++) {
+            Entity entity = 0;
+            if (const auto error = reader.Read(entity); error != err::ok) {
+                return error;
+            }
+            if (entity >= MAX_ENTITY_COUNT) {
+                return err::entity_limit;
+            }
+            if (living[entity] || listed[entity]) {
+                return err::invalid_argument;
+            }
+            listed.set(entity);
+        }
+
+        constexpr auto signatures_size = sizeof(std::array<Signature, MAX_ENTITY_COUNT>);
+        if (!entities) {
+            return reader.Skip(signatures_size);
+        }
+        entities->living = living;
+        return reader.Read(entities->signatures.data(), signatures_size);
+    }
+
+    // Everything is checked before the members change, a corrupt snapshot leaves them as they are
+    err EntityManager::Load(SnapshotReader& reader) {
+        SnapshotReader check = reader;
+        if (const auto error = Validate(check); error != err::ok) {
+            return error;
+        }
+
+        reader.Read(living_entities_);
+        size_t available = 0;
+        reader.Read(available);
+        available_entities_.resize(available);
+        for (auto& entity : available_entities_) {
+            reader.Read(entity);
+        }
+        reader.Read(signatures_.data(), sizeof(signatures_));
+        entity_count_ = living_entities_.count();
+        return err::ok;
+    }
 }
\ No newline at end of file
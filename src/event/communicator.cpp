@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <event/event_bus.h>
 
 namespace ecs::event {
@@ -28,8 +30,91 @@ namespace ecs::event {
 	}
 
 	void Communicator::Broadcast(const Message& message) {
-		for (auto observer : observers_) {
-			observer->Notify(message);
+		notify(observers_, [&message](IObserver& observer) {
+			observer.Notify(message);
+		});
+	}
+
+	bool Communicator::AddObserver(ecs::core::Entity receiver, std::shared_ptr<IObserver> observer) {
+		if (HasObserver(receiver, observer)) {
+			return false;
+		}
+		if (receiver >= routed_observers_.size()) {
+			routed_observers_.resize(receiver + 1);
+		}
+		routed_observers_[receiver].emplace_back(observer);
+		return true;
+	}
+
+	bool Communicator::RemoveObserver(ecs::core::Entity receiver, std::shared_ptr<IObserver> observer) {
+		if (receiver >= routed_observers_.size()) {
+			return false;
+		}
+		auto& observers = routed_observers_[receiver];
+		auto element = std::find(observers.begin(), observers.end(), observer);
+		if (element == observers.end()) {
+			return false;
+		}
+		observers.erase(element);
+		return true;
+	}
+
+	bool Communicator::HasObserver(ecs::core::Entity receiver, std::shared_ptr<IObserver> observer) const {
+		if (receiver >= routed_observers_.size()) {
+			return false;
+		}
+		const auto& observers = routed_observers_[receiver];
+		return std::find(observers.begin(), observers.end(), observer) != observers.end();
+	}
+
+	void Communicator::Send(const Message& message) {
+		const auto receiver = message.GetInvolved().second;
+
+		if (receiver >= routed_observers_.size()) {
+			return;
+		}
+		notify(routed_observers_[receiver], [&message](IObserver& observer) {
+			observer.Notify(message);
+		});
+	}
+
+	void Communicator::Post(Message message) {
+		const auto receiver = message.GetInvolved().second;
+
+		if (receiver >= routed_observers_.size() || routed_observers_[receiver].empty()) {
+			return;
+		}
+		if (receiver >= pending_.size()) {
+			pending_.resize(receiver + 1);
+		}
+		auto& batch = pending_[receiver];
+		if (batch.empty()) {
+			pending_receivers_.push_back(receiver);
+		}
+		batch.emplace_back(std::move(message));
+	}
+
+	void Communicator::Flush() {
+		// observers may post while notified, their messages go to the swapped in buffers
+		flushing_.swap(pending_);
+		flushing_receivers_.swap(pending_receivers_);
+		for (const auto receiver : flushing_receivers_) {
+			auto& batch = flushing_[receiver];
+
+			notify(routed_observers_[receiver], [&batch](IObserver& observer) {
+				observer.NotifyBatch(batch);
+			});
+			// keeps the capacity for the next frame
+			batch.clear();
+		}
+		flushing_receivers_.clear();
+	}
+
+	size_t Communicator::Pending() const {
+		size_t count = 0;
+		for (const auto receiver : pending_receivers_) {
+			count += pending_[receiver].size();
 		}
+		return count;
 	}
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include <utils/clock_chrono.h>
 
 namespace utils::clock {
-	Chrono::Chrono() : start_time_(std::chrono::high_resolution_clock::now()), stop_time_(start_time_) {}
+	Chrono::Chrono() : start_time_(Clock::now()), stop_time_(start_time_) {}
 
 	utils::time_ms Chrono::TimePassed() const {
 		const auto duration = stop_time_ - start_time_;
@@ -9,13 +9,18 @@ namespace utils::clock {
 		return duration_ms.count();
 	}
 
+	utils::time_ns Chrono::TimePassedNs() const {
+		const auto duration = stop_time_ - start_time_;
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+	}
+
 	void Chrono::Start() {
-		start_time_ = std::chrono::high_resolution_clock::now();
+		start_time_ = Clock::now();
 		stop_time_ = start_time_;
 	}
 
 	utils::time_ms Chrono::Stop() {
-		stop_time_ = std::chrono::high_resolution_clock::now();
+		stop_time_ = Clock::now();
 		return TimePassed();
 	}
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <thread>
+
+#include <utils/fixed_step_loop.h>
+
+namespace utils {
+	FixedStepLoop::FixedStepLoop(std::chrono::nanoseconds step, size_t max_catch_up) :
+		step_(step.count() > 0 ? step : std::chrono::nanoseconds(1)),
+		max_catch_up_(max_catch_up > 0 ? max_catch_up : 1) {}
+
+	void FixedStepLoop::Stop() {
+		running_ = false;
+	}
+
+	void FixedStepLoop::SetFrameCap(std::chrono::nanoseconds frame_time) {
+		frame_cap_ = std::max(frame_time, std::chrono::nanoseconds(0));
+	}
+
+	void FixedStepLoop::WaitForNextStep() {
+		WaitUntil(Clock::now() + TimeToNextStep());
+	}
+
+	void FixedStepLoop::WaitUntil(Clock::time_point due) {
+		if (const auto sleep = due - Clock::now() - spin_threshold_; sleep.count() > 0) {
+			const auto before = Clock::now();
+			std::this_thread::sleep_for(sleep);
+			const auto oversleep = (Clock::now() - before) - sleep;
+			// adapt to the sleep precision of the os, but keep spinning bounded
+			spin_threshold_ = std::clamp<std::chrono::nanoseconds>((spin_threshold_ * 7 + oversleep) / 8,
+				std::chrono::microseconds(50), std::chrono::milliseconds(4));
+		}
+		while (Clock::now() < due) {
+			std::this_thread::yield();
+		}
+	}
+
+	std::chrono::nanoseconds FixedStepLoop::TimeToNextStep() const {
+		if (!started_) {
+			return std::chrono::nanoseconds(0);
+		}
+		const auto pending = accumulator_ + (Clock::now() - previous_);
+		return std::max(step_ - pending, std::chrono::nanoseconds(0));
+	}
+
+	double FixedStepLoop::Alpha() const {
+		return static_cast<double>(accumulator_.count()) / static_cast<double>(step_.count());
+	}
+
+	std::chrono::nanoseconds FixedStepLoop::StepTime() const {
+		return step_;
+	}
+
+	uint64_t FixedStepLoop::Steps() const {
+		return steps_;
+	}
+
+	uint64_t FixedStepLoop::DroppedSteps() const {
+		return dropped_steps_;
+	}
+}
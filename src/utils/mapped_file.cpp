@@ -0,0 +1,118 @@
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utils/mapped_file.h>
+
+namespace utils {
+	MappedFile::MappedFile(const std::string& filename) {
+		Open(filename);
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			Close();
+			std::swap(data_, other.data_);
+			std::swap(size_, other.size_);
+			std::swap(file_, other.file_);
+#ifdef _WIN32
+			std::swap(mapping_, other.mapping_);
+#endif
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile() {
+		Close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const std::string& filename) {
+		Close();
+		file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE) {
+			file_ = nullptr;
+			return false;
+		}
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+			Close();
+			return false;
+		}
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_ == nullptr) {
+			Close();
+			return false;
+		}
+		data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+		if (data_ == nullptr) {
+			Close();
+			return false;
+		}
+		size_ = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close() {
+		if (data_) {
+			UnmapViewOfFile(data_);
+		}
+		if (mapping_) {
+			CloseHandle(mapping_);
+		}
+		if (file_) {
+			CloseHandle(file_);
+		}
+		data_ = nullptr;
+		size_ = 0;
+		mapping_ = nullptr;
+		file_ = nullptr;
+	}
+#else
+	bool MappedFile::Open(const std::string& filename) {
+		Close();
+		file_ = open(filename.c_str(), O_RDONLY);
+		if (file_ < 0) {
+			return false;
+		}
+		struct stat status {};
+		if (fstat(file_, &status) != 0 || status.st_size == 0) {
+			Close();
+			return false;
+		}
+		void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file_, 0);
+		if (data == MAP_FAILED) {
+			Close();
+			return false;
+		}
+		// the whole file is read right after mapping
+		madvise(data, static_cast<size_t>(status.st_size), MADV_WILLNEED);
+		data_ = static_cast<const std::byte*>(data);
+		size_ = static_cast<size_t>(status.st_size);
+		return true;
+	}
+
+	void MappedFile::Close() {
+		if (data_) {
+			munmap(const_cast<std::byte*>(data_), size_);
+		}
+		if (file_ >= 0) {
+			close(file_);
+		}
+		data_ = nullptr;
+		size_ = 0;
+		file_ = -1;
+	}
+#endif
+}
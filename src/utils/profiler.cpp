@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+#include <utils/profiler.h>
+
+namespace utils::profiler {
+	namespace {
+		std::mutex buffers_mutex;
+		std::vector<std::shared_ptr<ZoneBuffer>> buffers;
+		uint32_t thread_counter = 0;
+
+		ZoneBuffer& threadBuffer() {
+			thread_local std::shared_ptr<ZoneBuffer> buffer = []() {
+				std::lock_guard<std::mutex> lock(buffers_mutex);
+				auto created = std::make_shared<ZoneBuffer>(thread_counter++);
+				buffers.push_back(created);
+				return created;
+			}();
+			return *buffer;
+		}
+
+		void writeEscaped(std::ostream& stream, const char* text) {
+			for (const char* it = text; *it != '\0'; it++) {
+				if (*it == '"' || *it == '\\') {
+					stream << '\\';
+				}
+				stream << *it;
+			}
+		}
+	}
+
+	ZoneBuffer::ZoneBuffer(uint32_t thread) : zones_(PROFILER_ZONE_CAPACITY), next_(0), thread_(thread) {}
+
+	size_t ZoneBuffer::Size() const {
+		return next_ < PROFILER_ZONE_CAPACITY ? next_ : PROFILER_ZONE_CAPACITY;
+	}
+
+	const Zone& ZoneBuffer::At(size_t index) const {
+		const auto first = next_ - Size();
+		return zones_[(first + index) % PROFILER_ZONE_CAPACITY];
+	}
+
+	void ZoneBuffer::Clear() {
+		next_ = 0;
+	}
+
+	uint32_t ZoneBuffer::Thread() const {
+		return thread_;
+	}
+
+	void Profiler::Record(const char* name, uint64_t start, uint64_t end) {
+		threadBuffer().Add({ name, start, end });
+	}
+
+	void Profiler::ExportChromeTrace(std::ostream& stream) {
+		std::lock_guard<std::mutex> lock(buffers_mutex);
+
+		uint64_t origin = UINT64_MAX;
+		for (const auto& buffer : buffers) {
+			for (size_t index = 0; index < buffer->Size(); index++) {
+				origin = std::min(origin, buffer->At(index).start);
+			}
+		}
+		const double us_per_tick = 1.0e6 / utils::clock::TicksPerSecond();
+
+		// microseconds with a nanosecond fraction, the default precision drops it after a second
+		const auto flags = stream.flags();
+		const auto precision = stream.precision();
+		stream << std::fixed << std::setprecision(3);
+
+		stream << "{\"traceEvents\":[";
+		bool first = true;
+		for (const auto& buffer : buffers) {
+			for (size_t index = 0; index < buffer->Size(); index++) {
+				const auto& zone = buffer->At(index);
+				stream << (first ? "\n" : ",\n") << "{\"name\":\"";
+				writeEscaped(stream, zone.name);
+				stream << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->Thread()
+					<< ",\"ts\":" << (zone.start - origin) * us_per_tick
+					<< ",\"dur\":" << (zone.end - zone.start) * us_per_tick << "}";
+				first = false;
+			}
+		}
+		stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+
+	bool Profiler::ExportChromeTrace(const std::string& filename) {
+		std::ofstream file(filename, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			return false;
+		}
+		ExportChromeTrace(file);
+		return file.good();
+	}
+
+	size_t Profiler::ZoneCount() {
+		std::lock_guard<std::mutex> lock(buffers_mutex);
+		size_t count = 0;
+		for (const auto& buffer : buffers) {
+			count += buffer->Size();
+		}
+		return count;
+	}
+
+	void Profiler::Clear() {
+		std::lock_guard<std::mutex> lock(buffers_mutex);
+		for (const auto& buffer : buffers) {
+			buffer->Clear();
+		}
+	}
+}
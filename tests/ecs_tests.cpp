@@ -1,4 +1,13 @@
+#include <bitset>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/benchmark/catch_benchmark.hpp>
@@ -10,6 +19,60 @@
 #include <ecs/core/system_manager.h>
 #include <ecs/core/ecs.h>
 
+namespace {
+    struct Name {
+        std::string value;
+    };
+
+    struct Health {
+        int value{0};
+    };
+
+    template<size_t N>
+    struct Setting {
+        size_t value{N};
+    };
+
+    // reads one resource type more than a system can track
+    struct GreedySystem : ecs::core::System {
+        ecs::core::err declared{ecs::core::err::ok};
+
+        GreedySystem() {
+            declare(std::make_index_sequence<ecs::core::MAX_RESOURCES + 1>{});
+        }
+
+        template<size_t... N>
+        void declare(std::index_sequence<N...>) {
+            declared = ReadsResources<Setting<N>...>();
+        }
+
+        virtual void update(ecs::core::time_ms) override {}
+    };
+}
+
+template<>
+struct ecs::core::TrackChanges<Health> {
+    static constexpr bool enabled = true;
+};
+
+template<>
+struct ecs::core::Serializer<Name> {
+    static constexpr bool enabled = true;
+
+    static void Write(Snapshot& snapshot, const Name& name) {
+        snapshot.Write(name.value.size());
+        snapshot.Write(name.value.data(), name.value.size());
+    }
+
+    static err Read(SnapshotReader& reader, Name& name) {
+        size_t size = 0;
+        if (const auto error = reader.Read(size); error != err::ok) return error;
+        if (size > reader.Remaining()) return err::invalid_argument;
+        name.value.resize(size);
+        return reader.Read(name.value.data(), size);
+    }
+};
+
 TEST_CASE("EntityManager create", "[entitymanager]") {
     ecs::core::EntityManager manager;
 
@@ -194,6 +257,162 @@ TEST_CASE("Component Array Layout", "[layout]") {
     }
 }
 
+namespace {
+    template<typename Array>
+    void checkLayout() {
+        Array array;
+        REQUIRE(array.Add(35, 35) == ecs::core::err::ok);
+        REQUIRE(array.Add(48, 48) == ecs::core::err::ok);
+        REQUIRE(array.Add(100, 100) == ecs::core::err::ok);
+        REQUIRE(array.Add(12, 12) == ecs::core::err::ok);
+        REQUIRE(array.Size() == 4);
+        // a second add keeps the first component
+        REQUIRE(array.Add(12, 0) == ecs::core::err::already_registered);
+        REQUIRE(array.Size() == 4);
+        REQUIRE(array.Get(12).data == 12);
+
+        REQUIRE(array.Remove(48) == ecs::core::err::ok);
+        REQUIRE(array.Remove(48) == ecs::core::err::no_entity);
+        REQUIRE(array.Add(7, 7) == ecs::core::err::ok);
+        REQUIRE(array.Size() == 4);
+        REQUIRE(array.Get(48).error == ecs::core::err::no_entity);
+        REQUIRE(array.Get(12).data == 12);
+
+        *array.GetMutable(100).data = 101;
+        int sum = 0;
+        array.ForEach([&sum](ecs::core::Entity entity, int& value) {
+            REQUIRE((value == static_cast<int>(entity) || value == 101));
+            sum += value;
+        });
+        REQUIRE(sum == 35 + 101 + 12 + 7);
+
+        ecs::core::Snapshot snapshot;
+        REQUIRE(array.Save(snapshot) == ecs::core::err::ok);
+        array.Clear();
+        REQUIRE(array.Get(12).error == ecs::core::err::no_entity);
+        ecs::core::SnapshotReader reader(snapshot);
+        REQUIRE(array.Load(reader) == ecs::core::err::ok);
+        REQUIRE(array.Size() == 4);
+        REQUIRE(array.Get(100).data == 101);
+        REQUIRE(array.Get(7).data == 7);
+
+        // an entity listed twice is rejected
+        ecs::core::Snapshot duplicate;
+        duplicate.Write(size_t{2});
+        duplicate.Write(ecs::core::Entity{5});
+        duplicate.Write(ecs::core::Entity{5});
+        duplicate.Write(1);
+        duplicate.Write(2);
+        ecs::core::SnapshotReader duplicate_reader(duplicate);
+        REQUIRE(array.Load(duplicate_reader) == ecs::core::err::invalid_argument);
+        REQUIRE(array.Size() == 0);
+        ecs::core::SnapshotReader reload(snapshot);
+        REQUIRE(array.Load(reload) == ecs::core::err::ok);
+
+        if (array.Packed()) {
+            const auto first = array.EntityAt(0).data;
+            const auto last = array.EntityAt(3).data;
+            REQUIRE(array.Swap(0, 3) == ecs::core::err::ok);
+            REQUIRE(array.EntityAt(0).data == last);
+            REQUIRE(array.IndexOf(first).data == 3);
+            REQUIRE(array.Get(100).data == 101);
+            REQUIRE(array.Get(7).data == 7);
+            REQUIRE(array.Swap(0, 4) == ecs::core::err::invalid_argument);
+        }
+        else {
+            REQUIRE(array.Swap(0, 1) == ecs::core::err::invalid_argument);
+        }
+    }
+
+    template<typename Array>
+    void benchmarkLayout(const char* name) {
+        // every fourth entity owns the component
+        Array array;
+        for (ecs::core::Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity += 4) {
+            array.Add(entity, static_cast<int>(entity));
+        }
+        BENCHMARK(std::string(name) + " Get") {
+            int sum = 0;
+            for (ecs::core::Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity += 4) {
+                sum += array.Get(entity).data;
+            }
+            return sum;
+        };
+        BENCHMARK(std::string(name) + " ForEach") {
+            int sum = 0;
+            array.ForEach([&sum](ecs::core::Entity, int& value) { sum += value; });
+            return sum;
+        };
+        BENCHMARK(std::string(name) + " Remove/Add") {
+            for (ecs::core::Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity += 4) {
+                array.Remove(entity);
+            }
+            for (ecs::core::Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity += 4) {
+                array.Add(entity, static_cast<int>(entity));
+            }
+            return array.Size();
+        };
+    }
+}
+
+TEST_CASE("Component Array layouts", "[layout]") {
+    checkLayout<ecs::core::CompressedComponentArray<int>>();
+    checkLayout<ecs::core::DirectComponentArray<int>>();
+    checkLayout<ecs::core::SparseComponentArray<int>>();
+    checkLayout<ecs::core::PagedComponentArray<int>>();
+
+    ecs::core::PagedSparseSet paged;
+    REQUIRE(paged.Add(1).data == 0);
+    REQUIRE(paged.Add(2).data == 1);
+    REQUIRE(paged.Add(ecs::core::MAX_ENTITY_COUNT - 1).data == 2);
+    REQUIRE(paged.Pages() == 2);
+
+    ecs::core::ComponentManager manager;
+    REQUIRE((manager.Register<int, ecs::core::Direct>()) == ecs::core::err::ok);
+    REQUIRE(manager.Add<int>(5, 42) == ecs::core::err::ok);
+    REQUIRE(manager.Get<int>(5).data == 42);
+
+    SECTION("Benchmark layouts") {
+        benchmarkLayout<ecs::core::CompressedComponentArray<int>>("Compressor");
+        benchmarkLayout<ecs::core::DirectComponentArray<int>>("Direct");
+        benchmarkLayout<ecs::core::SparseComponentArray<int>>("SparseSet");
+        benchmarkLayout<ecs::core::PagedComponentArray<int>>("PagedSparseSet");
+    }
+}
+
+TEST_CASE("Component Array change tracking", "[componentarray]") {
+    ecs::core::CompressedComponentArray<Health> array;
+    array.SetTick(1);
+    REQUIRE(array.Add(0, Health{10}) == ecs::core::err::ok);
+    REQUIRE(array.Add(1, Health{20}) == ecs::core::err::ok);
+    REQUIRE(array.Add(2, Health{30}) == ecs::core::err::ok);
+
+    array.SetTick(2);
+    array.GetMutable(1).data->value = 25;
+    REQUIRE(array.VersionOf(0) == 1);
+    REQUIRE(array.VersionOf(1) == 2);
+
+    std::vector<ecs::core::Entity> changed;
+    array.ForEachChanged(2, [&](ecs::core::Entity entity, const Health&) { changed.push_back(entity); });
+    REQUIRE(changed == std::vector<ecs::core::Entity>{1});
+
+    // the last slot moves into the removed one together with its version
+    REQUIRE(array.Remove(1) == ecs::core::err::ok);
+    REQUIRE(array.VersionOf(2) == 1);
+    changed.clear();
+    array.ForEachChanged(2, [&](ecs::core::Entity entity, const Health&) { changed.push_back(entity); });
+    REQUIRE(changed.empty());
+
+    struct Untracked {
+        int value{0};
+    };
+    ecs::core::CompressedComponentArray<Untracked> untracked;
+    REQUIRE(untracked.Add(0, Untracked{1}) == ecs::core::err::ok);
+    REQUIRE(untracked.VersionOf(0) == 0);
+    STATIC_REQUIRE(sizeof(ecs::core::CompressedComponentArray<Health>) >=
+        sizeof(ecs::core::CompressedComponentArray<Untracked>) + sizeof(ecs::core::Version) * ecs::core::MAX_ENTITY_COUNT);
+}
+
 TEST_CASE("Register component", "[component manager]") {
     struct Foo {
         int x;
@@ -299,7 +518,7 @@ TEST_CASE("Get components", "[component manager]") {
 TEST_CASE("Add Entity", "[system]") {
     class BarSystem : public ecs::core::System {
     public:
-        virtual void update(ecs::core::time_ms delta_time) override {}
+        virtual void update(ecs::core::time_ms) override {}
     };
     BarSystem system;
 
@@ -311,10 +530,10 @@ TEST_CASE("Add Entity", "[system]") {
 
 TEST_CASE("Register System", "[system manager]") {
     struct TestSystem : ecs::core::System {
-        virtual void update(ecs::core::time_ms delta_time) override {}
+        virtual void update(ecs::core::time_ms) override {}
     };
     struct FooSystem : ecs::core::System {
-        virtual void update(ecs::core::time_ms delta_time) override {}
+        virtual void update(ecs::core::time_ms) override {}
     };
 
     ecs::core::SystemManager<int> manager;
@@ -334,10 +553,10 @@ TEST_CASE("Register System", "[system manager]") {
 
 TEST_CASE("Set system signature", "[system manager]") {
     struct TestSystem : ecs::core::System {
-        virtual void update(ecs::core::time_ms delta_time) override {}
+        virtual void update(ecs::core::time_ms) override {}
     };
     struct FooSystem : ecs::core::System {
-        virtual void update(ecs::core::time_ms delta_time) override {}
+        virtual void update(ecs::core::time_ms) override {}
     };
 
     ecs::core::SystemManager<int> manager;
@@ -353,10 +572,10 @@ TEST_CASE("Set system signature", "[system manager]") {
 
 TEST_CASE("Set Entity Signature" "[system manager]") {
     struct TestSystem : ecs::core::System {
-        virtual void update(ecs::core::time_ms delta_time) override {}
+        virtual void update(ecs::core::time_ms) override {}
     };
     struct FooSystem : ecs::core::System {
-        virtual void update(ecs::core::time_ms delta_time) override {}
+        virtual void update(ecs::core::time_ms) override {}
     };
 
     ecs::core::SystemManager<int> manager;
@@ -380,14 +599,106 @@ TEST_CASE("Set Entity Signature" "[system manager]") {
     }
 }
 
+TEST_CASE("Frame pipeline", "[system manager]") {
+    enum class Events {
+        spawn,
+    };
+    class SpawnObserver : public ecs::event::IObserver {
+    public:
+        size_t spawned{0};
+        virtual void Notify(const ecs::event::Message&) override {
+            spawned++;
+        }
+    };
+    struct OrderSystem : ecs::core::System {
+        std::vector<std::string> calls{};
+        virtual void preUpdate(ecs::core::time_ms) override {
+            calls.push_back("pre");
+        }
+        virtual void update(ecs::core::time_ms) override {
+            calls.push_back("update");
+        }
+    };
+
+    ecs::core::SystemManager<Events> manager;
+    auto system = std::make_shared<OrderSystem>();
+    auto observer = std::make_shared<SpawnObserver>();
+    REQUIRE(manager.Register(system) == ecs::core::err::ok);
+    REQUIRE(manager.GetEventBus().Subscribe(Events::spawn, observer));
+
+    manager.Post(Events::spawn);
+    manager.Post(Events::spawn);
+    manager.Defer([&]() {
+        system->calls.push_back("command");
+        REQUIRE(observer->spawned == 2);
+    });
+    REQUIRE(manager.GetEventQueue().Size() == 2);
+    REQUIRE(observer->spawned == 0);
+
+    manager.Update(16);
+    REQUIRE(manager.GetEventQueue().Empty());
+    REQUIRE(system->calls == std::vector<std::string>{"pre", "update", "command"});
+    REQUIRE(manager.PhaseTime(ecs::core::Phase::update).count() > 0);
+
+    manager.Update(16);
+    REQUIRE(observer->spawned == 2);
+    REQUIRE(system->calls.size() == 5);
+}
+
+TEST_CASE("System stats", "[system manager]") {
+    struct SleepSystem : ecs::core::System {
+        virtual void update(ecs::core::time_ms) override {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    };
+    struct IdleSystem : ecs::core::System {
+        virtual void update(ecs::core::time_ms) override {}
+    };
+
+    ecs::core::SystemManager<int> manager;
+    REQUIRE(manager.GetStats<SleepSystem>().error == ecs::core::err::not_registered);
+    REQUIRE(manager.Register<SleepSystem>() == ecs::core::err::ok);
+    REQUIRE(manager.Register<IdleSystem>() == ecs::core::err::ok);
+    REQUIRE(manager.SetSystemSignature<SleepSystem>(ecs::core::Signature(1)) == ecs::core::err::ok);
+    manager.SetEntitySignature(0, ecs::core::Signature(1));
+    manager.SetEntitySignature(1, ecs::core::Signature(1));
+
+    REQUIRE(manager.GetStats<SleepSystem>().data.time.samples == 0);
+    for (int frame = 0; frame < 10; frame++) {
+        manager.Update(16);
+    }
+
+    const auto stats = manager.GetStats<SleepSystem>();
+    REQUIRE(stats.error == ecs::core::err::ok);
+    REQUIRE(stats.data.time.samples == 10);
+    REQUIRE(stats.data.entities == 2);
+    REQUIRE(stats.data.time.min >= 200000);
+    REQUIRE(stats.data.time.min <= stats.data.time.avg);
+    REQUIRE(stats.data.time.avg <= stats.data.time.max);
+    REQUIRE(stats.data.time.p95 <= stats.data.time.p99);
+    REQUIRE(stats.data.time.p99 <= stats.data.time.max);
+    REQUIRE(manager.GetStats<IdleSystem>().data.entities == 0);
+    REQUIRE(manager.GetStats().size() == 2);
+    REQUIRE(manager.GetPhaseStats(ecs::core::Phase::update).min >= stats.data.time.min);
+
+    std::stringstream stream;
+    logging::Logger::SetStream(stream);
+    manager.SetStatsLogInterval(2);
+    manager.Update(16);
+    REQUIRE(stream.str().empty());
+    manager.Update(16);
+    REQUIRE(stream.str().find("2 entities") != std::string::npos);
+    logging::Logger::SetStream(std::cout);
+}
+
 TEST_CASE("Add systems", "[ecs]") {
     struct TestSystem : ecs::core::System {
-        virtual void update(ecs::core::time_ms delta_time) override {
+        virtual void update(ecs::core::time_ms) override {
 
         }
     };
     struct FooSystem : ecs::core::System {
-        virtual void update(ecs::core::time_ms delta_time) override {
+        virtual void update(ecs::core::time_ms) override {
 
         }
     };
@@ -413,4 +724,930 @@ TEST_CASE("Add/get/remove components", "[ecs]") {
     REQUIRE(ecs.GetComponent<Pos>(entity).data.y_ == 0);
     REQUIRE(ecs.RemoveComponent<Pos>(entity) == ecs::core::err::ok);
     REQUIRE(ecs.GetComponent<Pos>(entity).error == ecs::core::err::no_entity);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Event components", "[ecs]") {
+    struct Hit {
+        int damage{0};
+    };
+    struct HitSystem : ecs::core::System {
+        virtual void update(ecs::core::time_ms) override {}
+    };
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterEvent<Hit>() == ecs::core::err::ok);
+    REQUIRE(ecs.RegisterSystem<HitSystem>() == ecs::core::err::ok);
+    ecs::core::Signature signature;
+    signature.set(ecs.GetComponentType<Hit>());
+    REQUIRE(ecs.SetSystemSignature<HitSystem>(signature) == ecs::core::err::ok);
+
+    const auto first = ecs.CreateEntity().data;
+    const auto second = ecs.CreateEntity().data;
+
+    REQUIRE(ecs.EmitEvent(first, Hit{5}) == ecs::core::err::ok);
+    REQUIRE(ecs.EmitEvent(second, Hit{7}) == ecs::core::err::ok);
+    REQUIRE(ecs.EmitEvent(second, Hit{1}) == ecs::core::err::already_registered);
+
+    int total = 0;
+    size_t count = 0;
+    REQUIRE(ecs.ForEachComponent<Hit>([&](ecs::core::Entity, Hit& hit) {
+        total += hit.damage;
+        count++;
+    }) == ecs::core::err::ok);
+    REQUIRE(count == 2);
+    REQUIRE(total == 12);
+
+    ecs.ClearEvents();
+    count = 0;
+    ecs.ForEachComponent<Hit>([&](ecs::core::Entity, Hit&) { count++; });
+    REQUIRE(count == 0);
+    REQUIRE(ecs.GetComponent<Hit>(first).error == ecs::core::err::no_entity);
+    REQUIRE(ecs.EmitEvent(second, Hit{1}) == ecs::core::err::ok);
+
+    ecs.Update(16);
+    REQUIRE(ecs.GetComponent<Hit>(second).error == ecs::core::err::no_entity);
+}
+
+TEST_CASE("Event components after an unrelated system", "[ecs]") {
+    struct Pos {
+        float x{0};
+    };
+    struct Hit {
+        int damage{0};
+    };
+    struct MoveSystem : ecs::core::System {
+        virtual void update(ecs::core::time_ms) override {}
+    };
+    struct HitSystem : ecs::core::System {
+        virtual void update(ecs::core::time_ms) override {}
+    };
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterComponent<Pos>() == ecs::core::err::ok);
+    REQUIRE(ecs.RegisterEvent<Hit>() == ecs::core::err::ok);
+    // the entity stays in the move system while its events come and go
+    auto move = std::make_shared<MoveSystem>();
+    auto hit = std::make_shared<HitSystem>();
+    REQUIRE(ecs.RegisterSystem(move) == ecs::core::err::ok);
+    REQUIRE(ecs.RegisterSystem(hit) == ecs::core::err::ok);
+    ecs::core::Signature moving;
+    moving.set(ecs.GetComponentType<Pos>());
+    ecs::core::Signature hits;
+    hits.set(ecs.GetComponentType<Hit>());
+    REQUIRE(ecs.SetSystemSignature<MoveSystem>(moving) == ecs::core::err::ok);
+    REQUIRE(ecs.SetSystemSignature<HitSystem>(hits) == ecs::core::err::ok);
+
+    const auto entity = ecs.CreateEntity().data;
+    REQUIRE(ecs.AddComponent(entity, Pos{1}) == ecs::core::err::ok);
+    REQUIRE(move->Size() == 1);
+    for (int frame = 0; frame < 3; frame++) {
+        REQUIRE(ecs.EmitEvent(entity, Hit{frame}) == ecs::core::err::ok);
+        REQUIRE(hit->Size() == 1);
+        ecs.ClearEvents();
+        REQUIRE(hit->Size() == 0);
+        REQUIRE(move->Size() == 1);
+    }
+}
+
+TEST_CASE("Tag components", "[ecs]") {
+    struct Enemy {};
+    struct Jumped {};
+    struct Pos {
+        float x_{0}, y_{0};
+    };
+    struct EnemySystem : ecs::core::System {
+        virtual void update(ecs::core::time_ms) override {}
+    };
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterComponent<Enemy>() == ecs::core::err::ok);
+    REQUIRE(ecs.RegisterComponent<Enemy>() == ecs::core::err::already_registered);
+    REQUIRE(ecs.RegisterComponent<Pos>() == ecs::core::err::ok);
+    REQUIRE(ecs.RegisterEvent<Jumped>() == ecs::core::err::ok);
+    auto system = std::make_shared<EnemySystem>();
+    REQUIRE(ecs.RegisterSystem<EnemySystem>(system) == ecs::core::err::ok);
+    ecs::core::Signature signature;
+    signature.set(ecs.GetComponentType<Enemy>());
+    REQUIRE(ecs.SetSystemSignature<EnemySystem>(signature) == ecs::core::err::ok);
+
+    const auto first = ecs.CreateEntity().data;
+    const auto second = ecs.CreateEntity().data;
+    REQUIRE(ecs.AddComponent(first, Enemy{}) == ecs::core::err::ok);
+    REQUIRE(ecs.AddComponent(first, Pos{1, 2}) == ecs::core::err::ok);
+    REQUIRE(ecs.AddComponent(second, Enemy{}) == ecs::core::err::ok);
+    REQUIRE(system->Size() == 2);
+    REQUIRE(ecs.HasComponent<Enemy>(first));
+    REQUIRE(ecs.GetComponent<Enemy>(first).error == ecs::core::err::ok);
+
+    std::vector<ecs::core::Entity> enemies;
+    REQUIRE(ecs.ForEachComponent<Enemy>([&enemies](ecs::core::Entity entity, Enemy&) { enemies.push_back(entity); }) == ecs::core::err::ok);
+    REQUIRE(enemies == std::vector<ecs::core::Entity>{first, second});
+
+    signature.set(ecs.GetComponentType<Pos>());
+    size_t matching = 0;
+    ecs.ForEachEntity(signature, [&](ecs::core::Entity entity) {
+        REQUIRE(entity == first);
+        matching++;
+    });
+    REQUIRE(matching == 1);
+
+    REQUIRE(ecs.RemoveComponent<Enemy>(second) == ecs::core::err::ok);
+    REQUIRE(ecs.RemoveComponent<Enemy>(second) == ecs::core::err::no_entity);
+    REQUIRE(ecs.GetComponent<Enemy>(second).error == ecs::core::err::no_entity);
+    REQUIRE(system->Size() == 1);
+
+    // tag events are dropped at the end of the frame like stored ones
+    REQUIRE(ecs.EmitEvent(second, Jumped{}) == ecs::core::err::ok);
+    REQUIRE(ecs.HasComponent<Jumped>(second));
+    ecs.Update(16);
+    REQUIRE_FALSE(ecs.HasComponent<Jumped>(second));
+}
+
+TEST_CASE("Resources", "[ecs]") {
+    struct Camera {
+        float x_{0}, y_{0};
+    };
+    struct Config {
+        std::string name_{};
+    };
+    struct CameraSystem : ecs::core::System {
+        CameraSystem() {
+            WritesResources<Camera>();
+        }
+        virtual void update(ecs::core::time_ms) override {}
+    };
+    struct RenderSystem : ecs::core::System {
+        RenderSystem() {
+            ReadsResources<Camera, Config>();
+        }
+        virtual void update(ecs::core::time_ms) override {}
+    };
+    struct ConfigSystem : ecs::core::System {
+        ConfigSystem() {
+            ReadsResources<Config>();
+        }
+        virtual void update(ecs::core::time_ms) override {}
+    };
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.Resource<Camera>() == nullptr);
+    REQUIRE(ecs.SetResource(Camera{1, 2}) == ecs::core::err::ok);
+    auto* camera = ecs.Resource<Camera>();
+    REQUIRE(camera != nullptr);
+    REQUIRE(camera->x_ == 1);
+
+    // setting again assigns in place
+    REQUIRE(ecs.SetResource(Camera{3, 4}) == ecs::core::err::ok);
+    REQUIRE(ecs.Resource<Camera>() == camera);
+    REQUIRE(camera->y_ == 4);
+
+    REQUIRE(ecs.SetResource(Config{"a config name longer than the small string buffer"}) == ecs::core::err::ok);
+    REQUIRE(ecs.Resource<Config>()->name_ == "a config name longer than the small string buffer");
+    REQUIRE(ecs.RemoveResource<Config>() == ecs::core::err::ok);
+    REQUIRE(ecs.RemoveResource<Config>() == ecs::core::err::not_registered);
+    REQUIRE(ecs.Resource<Config>() == nullptr);
+
+    REQUIRE(ecs.RegisterSystem<CameraSystem>() == ecs::core::err::ok);
+    REQUIRE(ecs.RegisterSystem<RenderSystem>() == ecs::core::err::ok);
+    REQUIRE(ecs.SystemsConflict<CameraSystem, RenderSystem>().data);
+    REQUIRE(ecs.SystemsConflict<RenderSystem, CameraSystem>().data);
+    REQUIRE(ecs.SystemsConflict<CameraSystem, ConfigSystem>().error == ecs::core::err::not_registered);
+    REQUIRE(ecs.RegisterSystem<ConfigSystem>() == ecs::core::err::ok);
+    REQUIRE_FALSE(ecs.SystemsConflict<CameraSystem, ConfigSystem>().data);
+    REQUIRE_FALSE(ecs.SystemsConflict<RenderSystem, ConfigSystem>().data);
+
+    // running out of resource types is reported instead of thrown
+    const auto greedy = std::make_shared<GreedySystem>();
+    REQUIRE(greedy->declared == ecs::core::err::invalid_argument);
+    REQUIRE(greedy->ResourceError() == ecs::core::err::invalid_argument);
+    REQUIRE(ecs.RegisterSystem(greedy) == ecs::core::err::invalid_argument);
+    REQUIRE(ecs.RegisterSystem<GreedySystem>() == ecs::core::err::invalid_argument);
+    REQUIRE(ecs.SystemsConflict<GreedySystem, RenderSystem>().error == ecs::core::err::not_registered);
+    REQUIRE(ecs.SetResource(Setting<ecs::core::MAX_RESOURCES>{}) == ecs::core::err::invalid_argument);
+
+    BENCHMARK("Resource lookup") {
+        return ecs.Resource<Camera>()->x_;
+    };
+
+    REQUIRE(ecs.RegisterComponent<Camera>() == ecs::core::err::ok);
+    const auto holder = ecs.CreateEntity().data;
+    REQUIRE(ecs.AddComponent(holder, Camera{3, 4}) == ecs::core::err::ok);
+    BENCHMARK("Singleton component lookup") {
+        return ecs.GetComponent<Camera>(holder).data.x_;
+    };
+}
+
+TEST_CASE("Owning groups", "[ecs]") {
+    struct Pos {
+        float x_{0}, y_{0};
+    };
+    struct Vel {
+        float x_{0}, y_{0};
+    };
+    struct Mass {
+        float value_{0};
+    };
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterComponent<Pos>() == ecs::core::err::ok);
+    REQUIRE((ecs.RegisterComponent<Vel, ecs::core::SparseSet>()) == ecs::core::err::ok);
+    REQUIRE((ecs.RegisterComponent<Mass, ecs::core::Direct>()) == ecs::core::err::ok);
+
+    std::vector<ecs::core::Entity> entities;
+    for (size_t index = 0; index < 8; index++) {
+        const auto entity = ecs.CreateEntity().data;
+        entities.push_back(entity);
+        REQUIRE(ecs.AddComponent(entity, Pos{static_cast<float>(index), 0}) == ecs::core::err::ok);
+        // every second entity moves before the group exists
+        if (index % 2 == 0) {
+            REQUIRE(ecs.AddComponent(entity, Vel{1, 2}) == ecs::core::err::ok);
+        }
+    }
+
+    REQUIRE((ecs.GroupSize<Pos, Vel>().error) == ecs::core::err::not_registered);
+    REQUIRE((ecs.RegisterGroup<Pos, Mass>()) == ecs::core::err::invalid_argument);
+    REQUIRE((ecs.RegisterGroup<Pos, Vel>()) == ecs::core::err::ok);
+    REQUIRE((ecs.RegisterGroup<Vel, Pos>()) == ecs::core::err::already_registered);
+    REQUIRE((ecs.GroupSize<Vel, Pos>().data) == 4);
+
+    const auto checkGroup = [&ecs](size_t expected) {
+        size_t count = 0;
+        REQUIRE((ecs.ForEachGroup<Pos, Vel>([&](ecs::core::Entity entity, Pos& position, Vel& velocity) {
+            REQUIRE(ecs.GetComponent<Pos>(entity).data.x_ == position.x_);
+            REQUIRE(ecs.GetComponent<Vel>(entity).data.y_ == velocity.y_);
+            count++;
+        })) == ecs::core::err::ok);
+        REQUIRE(count == expected);
+        REQUIRE((ecs.GroupSize<Pos, Vel>().data) == expected);
+    };
+    checkGroup(4);
+
+    REQUIRE(ecs.AddComponent(entities[1], Vel{1, 2}) == ecs::core::err::ok);
+    checkGroup(5);
+    REQUIRE(ecs.RemoveComponent<Pos>(entities[0]) == ecs::core::err::ok);
+    checkGroup(4);
+    REQUIRE(ecs.RemoveComponent<Vel>(entities[2]) == ecs::core::err::ok);
+    checkGroup(3);
+    ecs.DestroyEntity(entities[4]);
+    checkGroup(2);
+
+    REQUIRE((ecs.ForEachGroup<Pos, Vel>([](ecs::core::Entity, Pos& position, Vel& velocity) {
+        position.x_ += velocity.x_;
+    })) == ecs::core::err::ok);
+    REQUIRE(ecs.GetComponent<Pos>(entities[6]).data.x_ == 7);
+
+    // the group is rebuilt after a restore
+    ecs::core::Snapshot snapshot;
+    REQUIRE(ecs.Save(snapshot) == ecs::core::err::ok);
+    REQUIRE(ecs.AddComponent(entities[3], Vel{1, 2}) == ecs::core::err::ok);
+    checkGroup(3);
+    REQUIRE(ecs.Restore(ecs::core::SnapshotReader(snapshot)) == ecs::core::err::ok);
+    checkGroup(2);
+
+    SECTION("Benchmark groups") {
+        ecs::core::EntityComponentSystem<int> grouped;
+        ecs::core::EntityComponentSystem<int> sparse;
+        for (auto* world : {&grouped, &sparse}) {
+            REQUIRE((world->RegisterComponent<Pos, ecs::core::SparseSet>()) == ecs::core::err::ok);
+            REQUIRE((world->RegisterComponent<Vel, ecs::core::SparseSet>()) == ecs::core::err::ok);
+            for (size_t index = 0; index < ecs::core::MAX_ENTITY_COUNT; index++) {
+                const auto entity = world->CreateEntity().data;
+                world->AddComponent(entity, Pos{});
+                if (index % 2 == 0) {
+                    world->AddComponent(entity, Vel{1, 1});
+                }
+            }
+        }
+        REQUIRE((grouped.RegisterGroup<Pos, Vel>()) == ecs::core::err::ok);
+
+        BENCHMARK("Pos+Vel owning group") {
+            grouped.ForEachGroup<Pos, Vel>([](ecs::core::Entity, Pos& position, Vel& velocity) {
+                position.x_ += velocity.x_;
+                position.y_ += velocity.y_;
+            });
+        };
+        BENCHMARK("Pos+Vel sparse set probe") {
+            sparse.ForEachComponent<Vel>([&sparse](ecs::core::Entity entity, Vel& velocity) {
+                auto* position = sparse.GetMutableComponent<Pos>(entity).data;
+                position->x_ += velocity.x_;
+                position->y_ += velocity.y_;
+            });
+        };
+    }
+}
+
+TEST_CASE("Sort components", "[ecs]") {
+    struct Depth {
+        float value_{0};
+    };
+    struct Material {
+        int id_{0};
+    };
+    struct Velocity {
+        float x_{0};
+    };
+    const auto byDepth = [](const Depth& first, const Depth& second) { return first.value_ < second.value_; };
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterComponent<Depth>() == ecs::core::err::ok);
+    REQUIRE((ecs.RegisterComponent<Material, ecs::core::SparseSet>()) == ecs::core::err::ok);
+    REQUIRE((ecs.RegisterComponent<Velocity, ecs::core::Direct>()) == ecs::core::err::ok);
+
+    std::vector<ecs::core::Entity> entities;
+    for (int index = 0; index < 64; index++) {
+        const auto entity = ecs.CreateEntity().data;
+        entities.push_back(entity);
+        REQUIRE(ecs.AddComponent(entity, Depth{static_cast<float>((index * 37) % 64)}) == ecs::core::err::ok);
+        REQUIRE(ecs.AddComponent(entity, Velocity{static_cast<float>(index)}) == ecs::core::err::ok);
+        if (index % 3 == 0) {
+            REQUIRE(ecs.AddComponent(entity, Material{index}) == ecs::core::err::ok);
+        }
+    }
+
+    const auto checkSorted = [&ecs]() {
+        float last = -1;
+        REQUIRE(ecs.ForEachComponent<Depth>([&last, &ecs](ecs::core::Entity entity, Depth& depth) {
+            REQUIRE(depth.value_ >= last);
+            REQUIRE(ecs.GetComponent<Depth>(entity).data.value_ == depth.value_);
+            last = depth.value_;
+        }) == ecs::core::err::ok);
+    };
+
+    // the scratch of the full sort comes from the world pool and is kept
+    const auto unsorted = ecs.MemoryStats(ecs::core::Subsystem::components).allocations;
+    REQUIRE(ecs.Sort<Depth>(byDepth) == ecs::core::err::ok);
+    checkSorted();
+    REQUIRE(ecs.GetComponent<Depth>(entities[1]).data.value_ == 37);
+    const auto allocations = ecs.MemoryStats(ecs::core::Subsystem::components).allocations;
+    REQUIRE(allocations > unsorted);
+    std::swap(ecs.GetMutableComponent<Depth>(entities[2]).data->value_, ecs.GetMutableComponent<Depth>(entities[3]).data->value_);
+    REQUIRE(ecs.Sort<Depth>(byDepth) == ecs::core::err::ok);
+    checkSorted();
+    REQUIRE(ecs.MemoryStats(ecs::core::Subsystem::components).allocations == allocations);
+
+    // small changes between frames are fixed up by insertion sort
+    ecs.GetMutableComponent<Depth>(entities[0]).data->value_ = 40.5f;
+    ecs.GetMutableComponent<Depth>(entities[5]).data->value_ = 0.5f;
+    REQUIRE(ecs.Sort<Depth>(byDepth, ecs::core::SortAlgorithm::insertion) == ecs::core::err::ok);
+    checkSorted();
+
+    REQUIRE((ecs.SortAs<Material, Depth>()) == ecs::core::err::ok);
+    float last = -1;
+    REQUIRE(ecs.ForEachComponent<Material>([&last, &ecs](ecs::core::Entity entity, Material& material) {
+        const auto depth = ecs.GetComponent<Depth>(entity).data.value_;
+        REQUIRE(depth >= last);
+        REQUIRE(material.id_ % 3 == 0);
+        last = depth;
+    }) == ecs::core::err::ok);
+
+    REQUIRE(ecs.Sort<Velocity>([](const Velocity& first, const Velocity& second) { return first.x_ < second.x_; }) == ecs::core::err::invalid_argument);
+
+    SECTION("Sorting an owned type keeps the group") {
+        REQUIRE((ecs.RegisterGroup<Depth, Material>()) == ecs::core::err::ok);
+        REQUIRE(ecs.Sort<Depth>([](const Depth& first, const Depth& second) { return first.value_ > second.value_; }) == ecs::core::err::ok);
+        float previous = 1000;
+        size_t count = 0;
+        REQUIRE((ecs.ForEachGroup<Depth, Material>([&](ecs::core::Entity entity, Depth& depth, Material& material) {
+            REQUIRE(depth.value_ <= previous);
+            REQUIRE(ecs.GetComponent<Material>(entity).data.id_ == material.id_);
+            previous = depth.value_;
+            count++;
+        })) == ecs::core::err::ok);
+        REQUIRE(count == 22);
+    }
+
+    SECTION("Benchmark sorting") {
+        // one component moves by about one place every frame
+        int frame = 0;
+        const auto jitter = [&]() {
+            frame++;
+            ecs.GetMutableComponent<Depth>(entities[frame % 64]).data->value_ += frame % 2 ? 1.5f : -1.5f;
+        };
+        BENCHMARK("Nearly sorted, full sort") {
+            jitter();
+            return ecs.Sort<Depth>(byDepth);
+        };
+        BENCHMARK("Nearly sorted, insertion sort") {
+            jitter();
+            return ecs.Sort<Depth>(byDepth, ecs::core::SortAlgorithm::insertion);
+        };
+    }
+}
+
+TEST_CASE("Prefabs", "[ecs]") {
+    struct Pos {
+        float x_{0}, y_{0};
+    };
+    struct Vel {
+        float x_{0}, y_{0};
+    };
+    struct Bullet {};
+    struct Unregistered {
+        int value_{0};
+    };
+    struct MoveSystem : ecs::core::System {
+        virtual void update(ecs::core::time_ms) override {}
+    };
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterComponent<Pos>() == ecs::core::err::ok);
+    REQUIRE((ecs.RegisterComponent<Vel, ecs::core::SparseSet>()) == ecs::core::err::ok);
+    REQUIRE(ecs.RegisterComponent<Bullet>() == ecs::core::err::ok);
+    auto system = std::make_shared<MoveSystem>();
+    REQUIRE(ecs.RegisterSystem(system) == ecs::core::err::ok);
+    ecs::core::Signature signature;
+    signature.set(ecs.GetComponentType<Pos>());
+    signature.set(ecs.GetComponentType<Vel>());
+    REQUIRE(ecs.SetSystemSignature<MoveSystem>(signature) == ecs::core::err::ok);
+
+    ecs::core::Prefab bullet;
+    bullet.Set(Pos{1, 2}).Set(Vel{0, 0}).Set(Bullet{}).Set(Vel{3, 4});
+    REQUIRE(bullet.GetSignature().count() == 3);
+
+    std::vector<ecs::core::Entity> created;
+    REQUIRE(ecs.Instantiate(bullet, 100, created) == ecs::core::err::ok);
+    REQUIRE(created.size() == 100);
+    REQUIRE(system->Size() == 100);
+    for (const auto entity : created) {
+        REQUIRE(ecs.GetComponent<Pos>(entity).data.y_ == 2);
+        REQUIRE(ecs.GetComponent<Vel>(entity).data.x_ == 3);
+        REQUIRE(ecs.HasComponent<Bullet>(entity));
+    }
+
+    // instances are regular entities
+    ecs.DestroyEntity(created[0]);
+    REQUIRE(system->Size() == 99);
+
+    ecs::core::Prefab broken;
+    broken.Set(Pos{}).Set(Unregistered{});
+    std::vector<ecs::core::Entity> failed;
+    REQUIRE(ecs.Instantiate(broken, 10, failed) == ecs::core::err::not_registered);
+    REQUIRE(failed.empty());
+    REQUIRE(ecs.ForEachComponent<Pos>([](ecs::core::Entity, Pos&) {}) == ecs::core::err::ok);
+    size_t positions = 0;
+    ecs.ForEachComponent<Pos>([&positions](ecs::core::Entity, Pos&) { positions++; });
+    REQUIRE(positions == 99);
+    REQUIRE(ecs.Instantiate(bullet, ecs::core::MAX_ENTITY_COUNT, failed) == ecs::core::err::entity_limit);
+
+    SECTION("Benchmark prefabs") {
+        // a separate world, the systems of the test would skew the comparison
+        ecs::core::EntityComponentSystem<int> world;
+        REQUIRE(world.RegisterComponent<Pos>() == ecs::core::err::ok);
+        REQUIRE((world.RegisterComponent<Vel, ecs::core::SparseSet>()) == ecs::core::err::ok);
+        REQUIRE(world.RegisterComponent<Bullet>() == ecs::core::err::ok);
+        std::vector<ecs::core::Entity> spawned;
+        BENCHMARK("Instantiate 1000 bullets") {
+            spawned.clear();
+            world.Instantiate(bullet, 1000, spawned);
+            for (const auto entity : spawned) {
+                world.DestroyEntity(entity);
+            }
+        };
+        BENCHMARK("Create 1000 bullets one by one") {
+            spawned.clear();
+            for (size_t index = 0; index < 1000; index++) {
+                const auto entity = world.CreateEntity().data;
+                world.AddComponent(entity, Pos{1, 2});
+                world.AddComponent(entity, Vel{3, 4});
+                world.AddComponent(entity, Bullet{});
+                spawned.push_back(entity);
+            }
+            for (const auto entity : spawned) {
+                world.DestroyEntity(entity);
+            }
+        };
+    }
+}
+
+TEST_CASE("Defragmentation", "[ecs]") {
+    struct Pos {
+        float x_{0};
+    };
+    struct Vel {
+        float x_{0};
+    };
+    struct Health {
+        int value_{0};
+    };
+    struct Grid {
+        int cell_{0};
+    };
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterComponent<Pos>() == ecs::core::err::ok);
+    REQUIRE((ecs.RegisterComponent<Vel, ecs::core::SparseSet>()) == ecs::core::err::ok);
+    REQUIRE((ecs.RegisterComponent<Health, ecs::core::PagedSparseSet>()) == ecs::core::err::ok);
+    REQUIRE((ecs.RegisterComponent<Grid, ecs::core::Direct>()) == ecs::core::err::ok);
+    REQUIRE(ecs.Fragmentation() == 0);
+
+    std::vector<ecs::core::Entity> entities;
+    for (int index = 0; index < 512; index++) {
+        const auto entity = ecs.CreateEntity().data;
+        entities.push_back(entity);
+        REQUIRE(ecs.AddComponent(entity, Pos{static_cast<float>(entity)}) == ecs::core::err::ok);
+        REQUIRE(ecs.AddComponent(entity, Vel{static_cast<float>(entity) * 2}) == ecs::core::err::ok);
+        REQUIRE(ecs.AddComponent(entity, Grid{index}) == ecs::core::err::ok);
+        if (index % 2 == 0) {
+            REQUIRE(ecs.AddComponent(entity, Health{index}) == ecs::core::err::ok);
+        }
+    }
+    REQUIRE(ecs.Fragmentation() == 0);
+
+    // swap removal in a scattered order shuffles the dense arrays
+    const auto churn = [&ecs, &entities]() {
+        for (size_t step = 0; step < entities.size() / 2; step++) {
+            const auto entity = entities[(step * 193) % entities.size()];
+            ecs.RemoveComponent<Pos>(entity);
+            ecs.RemoveComponent<Vel>(entity);
+        }
+        for (size_t step = 0; step < entities.size() / 2; step++) {
+            const auto entity = entities[(step * 193) % entities.size()];
+            ecs.AddComponent(entity, Vel{static_cast<float>(entity) * 2});
+            ecs.AddComponent(entity, Pos{static_cast<float>(entity)});
+        }
+    };
+    churn();
+    REQUIRE(ecs.Fragmentation() > 0.1f);
+    REQUIRE(ecs.Fragmentation<Pos>().data > 0.1f);
+    REQUIRE(ecs.Fragmentation<Grid>().error == ecs::core::err::invalid_argument);
+
+    // owned arrays are ordered in front of and behind the group end, one descent is left there
+    const auto checkOrdered = [&ecs](size_t allowed_descents = 0) {
+        REQUIRE(ecs.Fragmentation() == 0);
+        ecs::core::Entity last = 0;
+        size_t descents = 0;
+        REQUIRE(ecs.ForEachComponent<Pos>([&](ecs::core::Entity entity, Pos& pos) {
+            descents += entity < last;
+            REQUIRE(pos.x_ == static_cast<float>(entity));
+            REQUIRE(ecs.GetComponent<Vel>(entity).data.x_ == static_cast<float>(entity) * 2);
+            last = entity;
+        }) == ecs::core::err::ok);
+        REQUIRE(descents <= allowed_descents);
+    };
+
+    SECTION("Bounded steps") {
+        // one swap per misplaced component, the arrays hold 512 + 512 + 256 of them
+        size_t calls = 0;
+        while (ecs.Defragment(64) == 64) {
+            calls++;
+            REQUIRE(calls < 100);
+        }
+        checkOrdered();
+        REQUIRE(ecs.Defragment(64) < 64);
+    }
+
+    SECTION("Changes between steps") {
+        for (size_t frame = 0; frame < 200; frame++) {
+            ecs.Defragment(16);
+            const auto entity = entities[(frame * 7) % entities.size()];
+            ecs.RemoveComponent<Pos>(entity);
+            REQUIRE(ecs.AddComponent(entity, Pos{static_cast<float>(entity)}) == ecs::core::err::ok);
+            if (frame % 10 == 0) {
+                ecs.DestroyEntity(entities.back());
+                entities.pop_back();
+            }
+        }
+        while (ecs.Defragment(64) == 64) {}
+        checkOrdered();
+        REQUIRE(ecs.Fragmentation<Health>().data == 0);
+    }
+
+    SECTION("Owning groups stay packed") {
+        REQUIRE((ecs.RegisterGroup<Pos, Health>()) == ecs::core::err::ok);
+        churn();
+        REQUIRE(ecs.Fragmentation() > 0.1f);
+        while (ecs.Defragment(64) == 64) {}
+        checkOrdered(1);
+        REQUIRE((ecs.GroupSize<Pos, Health>().data) == 256);
+        ecs::core::Entity last = 0;
+        REQUIRE((ecs.ForEachGroup<Pos, Health>([&last](ecs::core::Entity entity, Pos& pos, Health& health) {
+            REQUIRE(entity >= last);
+            REQUIRE(pos.x_ == static_cast<float>(entity));
+            REQUIRE(health.value_ % 2 == 0);
+            last = entity;
+        })) == ecs::core::err::ok);
+    }
+
+    SECTION("Frames without events") {
+        struct Hit {
+            int damage_{0};
+        };
+        REQUIRE(ecs.RegisterEvent<Hit>() == ecs::core::err::ok);
+        while (ecs.Defragment(64) == 64) {}
+        ecs.Update(0);
+        REQUIRE(ecs.Defragment(64) < 64);
+
+        // clearing an event restarts the ordering pass
+        REQUIRE(ecs.EmitEvent(entities[0], Hit{1}) == ecs::core::err::ok);
+        ecs.Update(0);
+        REQUIRE(ecs.Defragment(64) == 64);
+        checkOrdered();
+    }
+
+    SECTION("Budget per frame") {
+        ecs.SetDefragmentBudget(128);
+        for (size_t frame = 0; frame < 30; frame++) {
+            ecs.Update(0);
+        }
+        checkOrdered();
+    }
+
+    SECTION("Benchmark defragmentation") {
+        const auto sum = [&ecs]() {
+            float total = 0;
+            ecs.ForEachComponent<Pos>([&total, &ecs](ecs::core::Entity entity, Pos& pos) {
+                total += pos.x_ + ecs.GetComponent<Vel>(entity).data.x_;
+            });
+            return total;
+        };
+        BENCHMARK("Two components, fragmented") {
+            return sum();
+        };
+        BENCHMARK("Defragment 256 steps") {
+            churn();
+            return ecs.Defragment(256);
+        };
+        while (ecs.Defragment(1024) == 1024) {}
+        BENCHMARK("Two components, defragmented") {
+            return sum();
+        };
+    }
+}
+
+TEST_CASE("World memory", "[ecs]") {
+    struct Hit {
+        int damage{0};
+    };
+    struct HitSystem : ecs::core::System {
+        virtual void update(ecs::core::time_ms) override {}
+    };
+    using ecs::core::Subsystem;
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterEvent<Hit>() == ecs::core::err::ok);
+    REQUIRE(ecs.RegisterSystem<HitSystem>() == ecs::core::err::ok);
+    ecs::core::Signature signature;
+    signature.set(ecs.GetComponentType<Hit>());
+    REQUIRE(ecs.SetSystemSignature<HitSystem>(signature) == ecs::core::err::ok);
+    REQUIRE(ecs.MemoryStats(Subsystem::components).allocations > 0);
+    REQUIRE(ecs.MemoryStats(Subsystem::systems).allocations > 0);
+
+    const auto entity = ecs.CreateEntity().data;
+    const auto frame = [&]() {
+        REQUIRE(ecs.EmitEvent(entity, Hit{1}) == ecs::core::err::ok);
+        void* scratch = ecs.FrameAllocator()->allocate(1024);
+        REQUIRE(scratch != nullptr);
+        ecs.Update(16);
+    };
+    // the command buffers are swapped every frame, both grow once
+    frame();
+    frame();
+
+    const auto components = ecs.MemoryStats(Subsystem::components).bytes_in_use;
+    const auto systems = ecs.MemoryStats(Subsystem::systems).bytes_in_use;
+    for (int i = 0; i < 10; i++) {
+        frame();
+    }
+    REQUIRE(ecs.MemoryStats(Subsystem::components).bytes_in_use == components);
+    REQUIRE(ecs.MemoryStats(Subsystem::systems).bytes_in_use == systems);
+
+    // an idle frame allocates nothing
+    const auto allocations = ecs.MemoryStats(Subsystem::systems).allocations;
+    ecs.Update(16);
+    REQUIRE(ecs.MemoryStats(Subsystem::systems).allocations == allocations);
+
+    SECTION("Shared systems outlive the world") {
+        auto shared = std::make_shared<HitSystem>();
+        {
+            ecs::core::EntityComponentSystem<int> world;
+            REQUIRE(world.RegisterSystem(shared) == ecs::core::err::ok);
+            for (int index = 0; index < 100; index++) {
+                world.CreateEntity();
+                REQUIRE(world.SetEntitySignature<HitSystem>(index, ecs::core::Signature{}) == ecs::core::err::ok);
+            }
+        }
+        REQUIRE(shared->Size() == 100);
+        REQUIRE(shared->Add(100) == ecs::core::err::ok);
+        shared->Clear();
+    }
+}
+
+TEST_CASE("Changed components", "[ecs]") {
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterComponent<Health>() == ecs::core::err::ok);
+    const auto first = ecs.CreateEntity().data;
+    const auto second = ecs.CreateEntity().data;
+    REQUIRE(ecs.AddComponent(first, Health{1}) == ecs::core::err::ok);
+    REQUIRE(ecs.AddComponent(second, Health{2}) == ecs::core::err::ok);
+
+    const auto count = [&ecs](ecs::core::Version since) {
+        size_t changed = 0;
+        ecs.ForEachChanged<Health>(since, [&changed](ecs::core::Entity, const Health&) { changed++; });
+        return changed;
+    };
+    const auto start = ecs.Tick();
+    REQUIRE(count(start) == 2);
+
+    ecs.Update(16);
+    const auto next = ecs.Tick();
+    REQUIRE(next == start + 1);
+    REQUIRE(count(next) == 0);
+
+    ecs.GetMutableComponent<Health>(second).data->value = 5;
+    REQUIRE(count(next) == 1);
+    REQUIRE(ecs.GetComponent<Health>(second).data.value == 5);
+
+    // read only passes leave the versions alone, mutable ones stamp every component
+    int total = 0;
+    REQUIRE(ecs.ForEachComponent<Health>([&total](ecs::core::Entity, const Health& health) { total += health.value; }) == ecs::core::err::ok);
+    REQUIRE(total == 6);
+    REQUIRE(count(next) == 1);
+    REQUIRE(ecs.ForEachComponent<Health>([](ecs::core::Entity, Health& health) { health.value++; }) == ecs::core::err::ok);
+    REQUIRE(count(next) == 2);
+}
+
+TEST_CASE("Snapshot", "[ecs]") {
+    struct Pos {
+        float x_{0}, y_{0};
+    };
+    struct PosSystem : ecs::core::System {
+        virtual void update(ecs::core::time_ms) override {}
+    };
+
+    ecs::core::EntityComponentSystem<int> ecs;
+    REQUIRE(ecs.RegisterComponent<Pos>() == ecs::core::err::ok);
+    REQUIRE(ecs.RegisterComponent<Name>() == ecs::core::err::ok);
+    auto system = std::make_shared<PosSystem>();
+    REQUIRE(ecs.RegisterSystem<PosSystem>(system) == ecs::core::err::ok);
+    ecs::core::Signature signature;
+    signature.set(ecs.GetComponentType<Pos>());
+    REQUIRE(ecs.SetSystemSignature<PosSystem>(signature) == ecs::core::err::ok);
+
+    const auto first = ecs.CreateEntity().data;
+    const auto second = ecs.CreateEntity().data;
+    REQUIRE(ecs.AddComponent(first, Pos{1, 2}) == ecs::core::err::ok);
+    REQUIRE(ecs.AddComponent(first, Name{"first"}) == ecs::core::err::ok);
+    REQUIRE(ecs.AddComponent(second, Name{"second"}) == ecs::core::err::ok);
+
+    ecs::core::Snapshot snapshot;
+    REQUIRE(ecs.Save(snapshot) == ecs::core::err::ok);
+
+    ecs.DestroyEntity(first);
+    REQUIRE(ecs.AddComponent(second, Pos{3, 4}) == ecs::core::err::ok);
+    const auto third = ecs.CreateEntity().data;
+    REQUIRE(system->Size() == 1);
+
+    REQUIRE(ecs.Restore(snapshot) == ecs::core::err::ok);
+    REQUIRE(ecs.GetComponent<Pos>(first).data.y_ == 2);
+    REQUIRE(ecs.GetComponent<Name>(first).data.value == "first");
+    REQUIRE(ecs.GetComponent<Name>(second).data.value == "second");
+    REQUIRE(ecs.GetComponent<Pos>(second).error == ecs::core::err::no_entity);
+    REQUIRE(system->Size() == 1);
+    // entity ids are handed out in the same order again
+    REQUIRE(ecs.CreateEntity().data == third);
+
+    SECTION("World file") {
+        const std::string filename = "ecs_tests_world.bin";
+        REQUIRE(ecs.SaveWorld(filename) == ecs::core::err::ok);
+        ecs.DestroyEntity(second);
+        REQUIRE(ecs.LoadWorld(filename) == ecs::core::err::ok);
+        REQUIRE(ecs.GetComponent<Name>(second).data.value == "second");
+        REQUIRE(ecs.LoadWorld("missing_world.bin") == ecs::core::err::invalid_argument);
+
+        // a truncated file is rejected without touching the world
+        REQUIRE(ecs.AddComponent(second, Pos{7, 8}) == ecs::core::err::ok);
+        {
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(snapshot.Data()), static_cast<std::streamsize>(snapshot.Size() - 4));
+        }
+        REQUIRE(ecs.LoadWorld(filename) != ecs::core::err::ok);
+        REQUIRE(ecs.GetComponent<Pos>(second).data.y_ == 8);
+        REQUIRE(system->Size() == 2);
+        std::remove(filename.c_str());
+    }
+    SECTION("Invalid data") {
+        REQUIRE(ecs.AddComponent(second, Pos{5, 6}) == ecs::core::err::ok);
+        const auto unchanged = [&]() {
+            REQUIRE(ecs.GetComponent<Pos>(first).data.y_ == 2);
+            REQUIRE(ecs.GetComponent<Pos>(second).data.y_ == 6);
+            REQUIRE(ecs.GetComponent<Name>(second).data.value == "second");
+            REQUIRE(ecs.GetSignature(second).data.test(ecs.GetComponentType<Pos>()));
+            REQUIRE(system->Size() == 2);
+        };
+        // cut in the middle of the components, the entities were loaded already
+        REQUIRE(ecs.Restore({snapshot.Data(), snapshot.Size() - 4}) != ecs::core::err::ok);
+        unchanged();
+        REQUIRE(ecs.Restore({snapshot.Data(), snapshot.Size() / 2}) != ecs::core::err::ok);
+        unchanged();
+        REQUIRE(ecs.Restore({snapshot.Data() + 1, snapshot.Size() - 1}) == ecs::core::err::invalid_argument);
+        unchanged();
+
+        // header, living entities and the free list size come before the free ids
+        const auto free_ids = 2 * sizeof(uint32_t) + sizeof(std::bitset<ecs::core::MAX_ENTITY_COUNT>) + sizeof(size_t);
+        std::vector<std::byte> corrupt(snapshot.Data(), snapshot.Data() + snapshot.Size());
+        const auto restore = [&ecs, &corrupt](ecs::core::Entity id, ecs::core::Entity next) {
+            std::memcpy(corrupt.data() + free_ids, &id, sizeof(id));
+            std::memcpy(corrupt.data() + free_ids + sizeof(id), &next, sizeof(next));
+            return ecs.Restore({corrupt.data(), corrupt.size()});
+        };
+        REQUIRE(restore(ecs::core::MAX_ENTITY_COUNT, third) == ecs::core::err::entity_limit);
+        REQUIRE(restore(first, third + 1) == ecs::core::err::invalid_argument);
+        REQUIRE(restore(third, third) == ecs::core::err::invalid_argument);
+        unchanged();
+        REQUIRE(ecs.CreateEntity().error == ecs::core::err::ok);
+    }
+    SECTION("Corrupt components") {
+        ecs::core::EntityComponentSystem<int> world;
+        REQUIRE(world.RegisterComponent<Pos>() == ecs::core::err::ok);
+        const auto a = world.CreateEntity().data;
+        const auto b = world.CreateEntity().data;
+        const auto bare = world.CreateEntity().data;
+        REQUIRE(world.AddComponent(a, Pos{1, 2}) == ecs::core::err::ok);
+        REQUIRE(world.AddComponent(b, Pos{3, 4}) == ecs::core::err::ok);
+        ecs::core::Snapshot saved;
+        REQUIRE(world.Save(saved) == ecs::core::err::ok);
+
+        // header, entities with their free list and signatures, then the Pos array:
+        // array count, type, entity count, entities
+        const auto free_count = 2 * sizeof(uint32_t) + sizeof(std::bitset<ecs::core::MAX_ENTITY_COUNT>);
+        size_t free = 0;
+        std::memcpy(&free, saved.Data() + free_count, sizeof(free));
+        const auto stored = free_count + sizeof(size_t) + free * sizeof(ecs::core::Entity) +
+            sizeof(ecs::core::Signature) * ecs::core::MAX_ENTITY_COUNT + 3 * sizeof(size_t);
+        std::vector<std::byte> corrupt(saved.Data(), saved.Data() + saved.Size());
+        ecs::core::Entity listed = 0;
+        std::memcpy(&listed, corrupt.data() + stored, sizeof(listed));
+        REQUIRE(listed == a);
+
+        REQUIRE(world.RemoveComponent<Pos>(a) == ecs::core::err::ok);
+        const auto restore = [&world, &corrupt, &stored](ecs::core::Entity second_listed) {
+            std::memcpy(corrupt.data() + stored + sizeof(ecs::core::Entity), &second_listed, sizeof(second_listed));
+            return world.Restore({corrupt.data(), corrupt.size()});
+        };
+        REQUIRE(restore(a) == ecs::core::err::invalid_argument);
+        REQUIRE(restore(bare) == ecs::core::err::invalid_argument);
+        REQUIRE(restore(100) == ecs::core::err::invalid_argument);
+        REQUIRE(world.GetComponent<Pos>(a).error == ecs::core::err::no_entity);
+        REQUIRE(world.GetComponent<Pos>(b).data.y_ == 4);
+        REQUIRE(restore(b) == ecs::core::err::ok);
+        REQUIRE(world.GetComponent<Pos>(a).data.y_ == 2);
+    }
+    SECTION("Components that can not be saved") {
+        // not trivially copyable and without a Serializer
+        struct Cache {
+            std::vector<int> values;
+        };
+        ecs::core::EntityComponentSystem<int> world;
+        REQUIRE(world.RegisterComponent<Pos>() == ecs::core::err::ok);
+        REQUIRE(world.RegisterComponent<Name>() == ecs::core::err::ok);
+        REQUIRE(world.RegisterComponent<Cache>() == ecs::core::err::ok);
+        const auto cached = world.CreateEntity().data;
+        REQUIRE(world.AddComponent(cached, Cache{{1, 2}}) == ecs::core::err::ok);
+        ecs::core::Snapshot unsaved;
+        REQUIRE(world.Save(unsaved) == ecs::core::err::not_serializable);
+
+        // restoring does not need to save the current world
+        REQUIRE(world.Restore(snapshot) == ecs::core::err::ok);
+        REQUIRE(world.GetComponent<Pos>(first).data.y_ == 2);
+        REQUIRE(world.GetComponent<Cache>(cached).error == ecs::core::err::no_entity);
+    }
+
+    BENCHMARK_ADVANCED("Snapshot a full world")(Catch::Benchmark::Chronometer meter) {
+        ecs::core::EntityComponentSystem<int> world;
+        world.RegisterComponent<Pos>();
+        for (size_t index = 0; index < ecs::core::MAX_ENTITY_COUNT; index++) {
+            world.AddComponent(world.CreateEntity().data, Pos{1, 2});
+        }
+        ecs::core::Snapshot full;
+        world.Save(full);
+        meter.measure([&] { return world.Save(full); });
+    };
+
+    BENCHMARK_ADVANCED("Load a full world file")(Catch::Benchmark::Chronometer meter) {
+        ecs::core::EntityComponentSystem<int> world;
+        world.RegisterComponent<Pos>();
+        for (size_t index = 0; index < ecs::core::MAX_ENTITY_COUNT; index++) {
+            world.AddComponent(world.CreateEntity().data, Pos{1, 2});
+        }
+        const std::string filename = "ecs_tests_bench_world.bin";
+        world.SaveWorld(filename);
+        meter.measure([&] { return world.LoadWorld(filename); });
+        std::remove(filename.c_str());
+    };
+
+    BENCHMARK_ADVANCED("Create a full world")(Catch::Benchmark::Chronometer meter) {
+        // one empty world per run, built outside the measurement like the loaded one
+        std::vector<std::unique_ptr<ecs::core::EntityComponentSystem<int>>> worlds;
+        for (int run = 0; run < meter.runs(); run++) {
+            worlds.push_back(std::make_unique<ecs::core::EntityComponentSystem<int>>());
+            worlds.back()->RegisterComponent<Pos>();
+        }
+        meter.measure([&](int run) {
+            auto& world = *worlds[run];
+            for (size_t index = 0; index < ecs::core::MAX_ENTITY_COUNT; index++) {
+                world.AddComponent(world.CreateEntity().data, Pos{1, 2});
+            }
+            return world.CreateEntity().error;
+        });
+    };
+}
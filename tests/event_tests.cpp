@@ -1,10 +1,13 @@
 #include <string>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
 #include <event/event.h>
 #include <event/event_bus.h>
 #include <event/event_queue.h>
+#include <event/evnt.h>
+#include <event/delegate.h>
 
 class MockObserver : public ecs::event::IObserver {
 private:
@@ -74,9 +77,135 @@ TEST_CASE("Communicator HasObserver", "[communicator]") {
 	}
 }
 
+TEST_CASE("Communicator routed", "[communicator]") {
+	class BatchObserver : public ecs::event::IObserver {
+	public:
+		size_t messages{ 0 };
+		size_t batches{ 0 };
+		virtual void Notify(const ecs::event::Message&) override {
+			messages++;
+		}
+		virtual void NotifyBatch(const std::vector<ecs::event::Message>& batch) override {
+			messages += batch.size();
+			batches++;
+		}
+	};
+	ecs::event::Communicator c;
+	auto target = std::make_shared<BatchObserver>();
+	auto other = std::make_shared<BatchObserver>();
+
+	REQUIRE(c.AddObserver(3, target) == true);
+	REQUIRE(c.AddObserver(3, target) == false);
+	REQUIRE(c.AddObserver(7, other) == true);
+	REQUIRE(c.HasObserver(3, target) == true);
+	REQUIRE(c.HasObserver(7, target) == false);
+
+	SECTION("Send") {
+		c.Send(ecs::event::Message{ 1, 3 });
+		REQUIRE(target->messages == 1);
+		REQUIRE(other->messages == 0);
+		c.Send(ecs::event::Message{ 1, 100 });
+		REQUIRE(target->messages == 1);
+	}
+	SECTION("Post/Flush") {
+		c.Post(ecs::event::Message{ 1, 3 });
+		c.Post(ecs::event::Message{ 2, 3 });
+		c.Post(ecs::event::Message{ 1, 7 });
+		REQUIRE(c.Pending() == 3);
+		REQUIRE(target->messages == 0);
+
+		c.Flush();
+		REQUIRE(c.Pending() == 0);
+		REQUIRE(target->messages == 2);
+		REQUIRE(target->batches == 1);
+		REQUIRE(other->messages == 1);
+		REQUIRE(other->batches == 1);
+	}
+	SECTION("Post while flushing") {
+		class ReplyObserver : public ecs::event::IObserver {
+		public:
+			ecs::event::Communicator* communicator{ nullptr };
+			size_t messages{ 0 };
+			virtual void Notify(const ecs::event::Message&) override {
+				messages++;
+				// enough posts to grow the pending buffers
+				for (ecs::core::Entity receiver = 0; receiver < 64; receiver++) {
+					communicator->Post(ecs::event::Message{ 3, receiver });
+				}
+			}
+		};
+		auto reply = std::make_shared<ReplyObserver>();
+		reply->communicator = &c;
+		REQUIRE(c.AddObserver(5, reply) == true);
+		c.Post(ecs::event::Message{ 1, 5 });
+		c.Post(ecs::event::Message{ 1, 5 });
+
+		c.Flush();
+		REQUIRE(reply->messages == 2);
+		REQUIRE(target->messages == 0);
+		// the replies are delivered by the next flush
+		REQUIRE(c.Pending() == 6);
+		c.Flush();
+		REQUIRE(target->messages == 2);
+		REQUIRE(other->messages == 2);
+		REQUIRE(reply->messages == 4);
+	}
+	SECTION("Subscribe while flushing") {
+		class SubscribeObserver : public ecs::event::IObserver {
+		public:
+			ecs::event::Communicator* communicator{ nullptr };
+			std::shared_ptr<ecs::event::IObserver> self{};
+			std::shared_ptr<ecs::event::IObserver> late{};
+			size_t batches{ 0 };
+			virtual void Notify(const ecs::event::Message&) override {}
+			virtual void NotifyBatch(const std::vector<ecs::event::Message>&) override {
+				batches++;
+				// grows this receiver's list and the receiver table, then leaves
+				communicator->AddObserver(5, late);
+				for (ecs::core::Entity receiver = 8; receiver < 64; receiver++) {
+					communicator->AddObserver(receiver, late);
+				}
+				communicator->RemoveObserver(5, self);
+			}
+		};
+		auto subscriber = std::make_shared<SubscribeObserver>();
+		subscriber->communicator = &c;
+		subscriber->self = subscriber;
+		subscriber->late = target;
+		auto second = std::make_shared<BatchObserver>();
+		REQUIRE(c.AddObserver(5, subscriber) == true);
+		REQUIRE(c.AddObserver(5, second) == true);
+		c.Post(ecs::event::Message{ 1, 5 });
+		c.Post(ecs::event::Message{ 1, 7 });
+
+		c.Flush();
+		REQUIRE(subscriber->batches == 1);
+		REQUIRE(second->batches == 1);
+		// observers added meanwhile get the next batch
+		REQUIRE(target->batches == 0);
+		REQUIRE(other->batches == 1);
+		REQUIRE(c.HasObserver(5, target) == true);
+		REQUIRE(c.HasObserver(5, subscriber) == false);
+		subscriber->self.reset();
+
+		c.Post(ecs::event::Message{ 1, 5 });
+		c.Flush();
+		REQUIRE(subscriber->batches == 1);
+		REQUIRE(second->batches == 2);
+		REQUIRE(target->batches == 1);
+	}
+	SECTION("Remove") {
+		REQUIRE(c.RemoveObserver(3, target) == true);
+		REQUIRE(c.RemoveObserver(3, target) == false);
+		c.Send(ecs::event::Message{ 1, 3 });
+		REQUIRE(target->messages == 0);
+	}
+}
+
 TEST_CASE("EventBus", "[eventbus]") {
 	enum class TestEvents {
 		foo,
+		bar,
 	};
 	ecs::event::EventBus<TestEvents> events;
 
@@ -109,6 +238,47 @@ TEST_CASE("EventBus", "[eventbus]") {
 		events.Dispatch(TestEvents::foo, message);
 		REQUIRE(observer->Info() == "Empty");
 	}
+	SECTION("Send routed") {
+		auto receiver = std::make_shared<MockObserver>();
+		auto bystander = std::make_shared<MockObserver>();
+		ecs::event::Message message{ 0, 1 };
+
+		message.SetData<std::string>("Hit");
+
+		REQUIRE(events.Subscribe(TestEvents::foo, 1, receiver) == true);
+		REQUIRE(events.Subscribe(TestEvents::foo, 2, bystander) == true);
+		events.Post(TestEvents::foo, message);
+		REQUIRE(receiver->Info() == "Empty");
+		events.Flush();
+		REQUIRE(receiver->Info() == "Hit");
+		REQUIRE(bystander->Info() == "Empty");
+	}
+	SECTION("Post while flushing") {
+		class ChainObserver : public ecs::event::IObserver {
+		public:
+			ecs::event::EventBus<TestEvents>* events{ nullptr };
+			size_t messages{ 0 };
+			virtual void Notify(const ecs::event::Message& message) override {
+				messages++;
+				if (message.GetInvolved().first == 0) {
+					events->Post(TestEvents::bar, ecs::event::Message{ 1, 1 });
+				}
+			}
+		};
+		auto chain = std::make_shared<ChainObserver>();
+		chain->events = &events;
+		REQUIRE(events.Subscribe(TestEvents::foo, 1, chain) == true);
+		events.Post(TestEvents::foo, ecs::event::Message{ 0, 1 });
+
+		events.Flush();
+		REQUIRE(chain->messages == 1);
+		REQUIRE(events.Subscribe(TestEvents::bar, 1, chain) == true);
+		events.Post(TestEvents::foo, ecs::event::Message{ 0, 1 });
+		events.Flush();
+		REQUIRE(chain->messages == 2);
+		events.Flush();
+		REQUIRE(chain->messages == 3);
+	}
 }
 
 TEST_CASE("EventQueue", "[eventqueue]") {
@@ -138,4 +308,109 @@ TEST_CASE("EventQueue", "[eventqueue]") {
 		queue.Clear();
 		REQUIRE(queue.Empty());
 	}
+}
+
+TEST_CASE("Delegate", "[delegate]") {
+	SECTION("Empty") {
+		ecs::event::Delegate<int(int)> delegate;
+		REQUIRE(!delegate);
+		REQUIRE_THROWS_AS(delegate(1), std::bad_function_call);
+	}
+	SECTION("Lambda capture") {
+		int offset = 5;
+		ecs::event::Delegate<int(int)> delegate = [offset](int x) { return x + offset; };
+		REQUIRE(delegate);
+		REQUIRE(delegate(1) == 6);
+	}
+	SECTION("Copy and move") {
+		auto text = std::make_shared<std::string>("Hello");
+		ecs::event::Delegate<size_t()> delegate = [text]() { return text->size(); };
+		auto copy = delegate;
+		REQUIRE(text.use_count() == 3);
+		auto moved = std::move(copy);
+		REQUIRE(moved() == 5);
+		REQUIRE(delegate() == 5);
+	}
+}
+
+TEST_CASE("EventHandler", "[eventhandler]") {
+	enum class Events {
+		foo,
+		bar,
+	};
+	ecs::event::EventHandler<Events> handler;
+
+	SECTION("Publish without listener") {
+		REQUIRE(handler.Listeners(Events::bar) == 0);
+		handler.Publish(Events::bar);
+	}
+	SECTION("Publish") {
+		int called = 0;
+		handler.Subscribe(Events::foo, [&called](ecs::event::Event<Events>&) { called++; });
+		handler.Subscribe(Events::foo, [&called](ecs::event::Event<Events>&) { called++; });
+		REQUIRE(handler.Listeners(Events::foo) == 2);
+
+		handler.Publish(Events::foo);
+		handler.Publish(Events::bar);
+		REQUIRE(called == 2);
+	}
+	SECTION("Publish data") {
+		std::string info{ "Empty" };
+		handler.Subscribe(Events::bar, [&info](ecs::event::Event<Events>& evnt) { info = evnt.GetData<std::string>(); });
+
+		ecs::event::Event<Events> evnt{ std::string{"Hello"}, Events::bar };
+		handler.Publish(evnt);
+		REQUIRE(info == "Hello");
+	}
+	SECTION("Unsubscribe") {
+		int called = 0;
+		handler.Subscribe(Events::foo, [&called](ecs::event::Event<Events>&) { called++; });
+		handler.Unsubscribe(Events::foo);
+		handler.Publish(Events::foo);
+		REQUIRE(called == 0);
+	}
+}
+
+TEST_CASE("Benchmark dispatch", "[eventhandler][benchmark]") {
+	enum class Events {
+		foo,
+	};
+	class CountingObserver : public ecs::event::IObserver {
+	public:
+		size_t count{ 0 };
+		virtual void Notify(const ecs::event::Message&) override {
+			count++;
+		}
+	};
+	constexpr size_t listener_count = 16;
+
+	size_t count = 0;
+	ecs::event::EventHandler<Events> handler;
+	ecs::event::EventBus<Events> bus;
+	std::vector<std::shared_ptr<CountingObserver>> observers;
+
+	for (size_t i = 0; i < listener_count; i++) {
+		handler.Subscribe(Events::foo, [&count](ecs::event::Event<Events>&) { count++; });
+
+		observers.push_back(std::make_shared<CountingObserver>());
+		bus.Subscribe(Events::foo, observers.back());
+	}
+
+	ecs::event::Event<Events> evnt{ Events::foo };
+	ecs::event::Message message;
+
+	BENCHMARK("EventHandler delegates") {
+		handler.Publish(evnt);
+		return count;
+	};
+	BENCHMARK("EventBus") {
+		bus.Dispatch(Events::foo, message);
+		return observers.front()->count;
+	};
+	BENCHMARK("IObserver::Notify") {
+		for (const auto& observer : observers) {
+			static_cast<ecs::event::IObserver*>(observer.get())->Notify(message);
+		}
+		return observers.front()->count;
+	};
 }
\ No newline at end of file
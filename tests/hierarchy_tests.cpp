@@ -0,0 +1,160 @@
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ecs/hierarchy/hierarchy.h>
+
+namespace {
+    using ecs::hierarchy::Transform;
+
+    std::vector<ecs::core::Entity> children(const ecs::hierarchy::Hierarchy& hierarchy, ecs::core::Entity entity) {
+        std::vector<ecs::core::Entity> found;
+        hierarchy.ForEachChild(entity, [&found](ecs::core::Entity child) { found.push_back(child); });
+        return found;
+    }
+
+    bool near(float first, float second) {
+        return std::abs(first - second) < 1e-4f;
+    }
+
+    // Splits every level into two halves updated on their own threads
+    void twoThreads(size_t begin, size_t end, const std::function<void(size_t, size_t)>& update) {
+        const auto middle = begin + (end - begin) / 2;
+        std::thread worker([&]() { update(begin, middle); });
+        update(middle, end);
+        worker.join();
+    }
+}
+
+TEST_CASE("Hierarchy propagation", "[hierarchy]") {
+    ecs::hierarchy::Hierarchy hierarchy;
+    // 3 is added before its parent moves below 1
+    REQUIRE(hierarchy.Add(1, Transform{10, 0, 0, 2}) == ecs::core::err::ok);
+    REQUIRE(hierarchy.Add(2, Transform{0, 5, 0, 1}) == ecs::core::err::ok);
+    REQUIRE(hierarchy.Add(3, Transform{1, 0, 0, 1}, 2) == ecs::core::err::ok);
+    REQUIRE(hierarchy.Add(3) == ecs::core::err::already_registered);
+    REQUIRE(hierarchy.Add(4, Transform{}, 9) == ecs::core::err::no_entity);
+
+    hierarchy.Propagate();
+    REQUIRE(hierarchy.Levels() == 2);
+    REQUIRE(near(hierarchy.World(3).data.x_, 1));
+    REQUIRE(near(hierarchy.World(3).data.y_, 5));
+
+    REQUIRE(hierarchy.SetParent(2, 1) == ecs::core::err::ok);
+    REQUIRE(hierarchy.SetParent(1, 3) == ecs::core::err::invalid_argument);
+    REQUIRE(hierarchy.SetParent(1, 1) == ecs::core::err::invalid_argument);
+    hierarchy.Propagate();
+    REQUIRE(hierarchy.Levels() == 3);
+    REQUIRE(hierarchy.Parent(2).data == 1);
+    REQUIRE(children(hierarchy, 1) == std::vector<ecs::core::Entity>{2});
+    REQUIRE(children(hierarchy, 2) == std::vector<ecs::core::Entity>{3});
+    // 1 scales its subtree by 2
+    REQUIRE(near(hierarchy.World(2).data.x_, 10));
+    REQUIRE(near(hierarchy.World(2).data.y_, 10));
+    REQUIRE(near(hierarchy.World(3).data.x_, 12));
+    REQUIRE(near(hierarchy.World(3).data.scale_, 2));
+
+    REQUIRE(hierarchy.SetLocal(1, Transform{0, 0, 1.5707964f, 1}) == ecs::core::err::ok);
+    hierarchy.Propagate();
+    REQUIRE(near(hierarchy.World(2).data.x_, -5));
+    REQUIRE(near(hierarchy.World(2).data.y_, 0));
+    REQUIRE(near(hierarchy.World(3).data.x_, -5));
+    REQUIRE(near(hierarchy.World(3).data.y_, 1));
+
+    // children of a removed node become roots
+    REQUIRE(hierarchy.Remove(2) == ecs::core::err::ok);
+    REQUIRE(hierarchy.Remove(2) == ecs::core::err::no_entity);
+    hierarchy.Propagate();
+    REQUIRE(hierarchy.Parent(3).data == ecs::hierarchy::no_parent);
+    REQUIRE(near(hierarchy.World(3).data.x_, 1));
+    REQUIRE(hierarchy.Size() == 2);
+    REQUIRE(children(hierarchy, 1).empty());
+    REQUIRE(hierarchy.ForEachChild(2, [](ecs::core::Entity) {}) == ecs::core::err::no_entity);
+}
+
+TEST_CASE("Hierarchy children", "[hierarchy]") {
+    ecs::hierarchy::Hierarchy hierarchy;
+    REQUIRE(hierarchy.Add(1) == ecs::core::err::ok);
+    for (ecs::core::Entity child = 2; child < 6; child++) {
+        REQUIRE(hierarchy.Add(child, Transform{}, 1) == ecs::core::err::ok);
+    }
+    REQUIRE(children(hierarchy, 1) == std::vector<ecs::core::Entity>{5, 4, 3, 2});
+
+    // unlinking from the middle, the front and the back of the list
+    REQUIRE(hierarchy.Remove(4) == ecs::core::err::ok);
+    REQUIRE(hierarchy.SetParent(5, 3) == ecs::core::err::ok);
+    REQUIRE(hierarchy.SetParent(2, ecs::hierarchy::no_parent) == ecs::core::err::ok);
+    REQUIRE(children(hierarchy, 1) == std::vector<ecs::core::Entity>{3});
+    REQUIRE(children(hierarchy, 3) == std::vector<ecs::core::Entity>{5});
+    REQUIRE(hierarchy.SetParent(2, 3) == ecs::core::err::ok);
+    REQUIRE(children(hierarchy, 3) == std::vector<ecs::core::Entity>{2, 5});
+
+    REQUIRE(hierarchy.Remove(3) == ecs::core::err::ok);
+    REQUIRE(children(hierarchy, 1).empty());
+    REQUIRE(hierarchy.Parent(2).data == ecs::hierarchy::no_parent);
+    REQUIRE(hierarchy.Parent(5).data == ecs::hierarchy::no_parent);
+    REQUIRE(children(hierarchy, 2).empty());
+
+    SECTION("Destroyed entities") {
+        // the world does not know the hierarchy, a destroyed entity keeps its node until removed
+        REQUIRE(hierarchy.Add(6, Transform{}, 1) == ecs::core::err::ok);
+        REQUIRE(hierarchy.Add(7, Transform{}, 6) == ecs::core::err::ok);
+        // the id comes back from CreateEntity for a new entity
+        REQUIRE(hierarchy.Add(6) == ecs::core::err::already_registered);
+        REQUIRE(hierarchy.Remove(6) == ecs::core::err::ok);
+        REQUIRE(hierarchy.Add(6) == ecs::core::err::ok);
+        REQUIRE(hierarchy.Parent(6).data == ecs::hierarchy::no_parent);
+        REQUIRE(children(hierarchy, 6).empty());
+        REQUIRE(children(hierarchy, 1).empty());
+        REQUIRE(hierarchy.Parent(7).data == ecs::hierarchy::no_parent);
+    }
+}
+
+TEST_CASE("Hierarchy levels", "[hierarchy]") {
+    // binary tree, node n is the parent of 2n + 1 and 2n + 2
+    ecs::hierarchy::Hierarchy sequential;
+    ecs::hierarchy::Hierarchy parallel;
+    for (auto* hierarchy : {&sequential, &parallel}) {
+        for (ecs::core::Entity entity = 0; entity < ecs::core::MAX_ENTITY_COUNT; entity++) {
+            const auto parent = entity == 0 ? ecs::hierarchy::no_parent : (entity - 1) / 2;
+            REQUIRE(hierarchy->Add(entity, Transform{1, 0, 0.1f, 1}, parent) == ecs::core::err::ok);
+        }
+        // move a subtree from the left to the right half
+        REQUIRE(hierarchy->SetParent(3, 6) == ecs::core::err::ok);
+    }
+    sequential.Propagate();
+    parallel.Propagate(twoThreads);
+    // the moved subtree reaches one level deeper
+    REQUIRE(sequential.Levels() == 14);
+
+    size_t checked = 0;
+    size_t last_depth = 0;
+    sequential.ForEach([&](ecs::core::Entity entity, const Transform& world) {
+        size_t depth = 0;
+        for (auto parent = entity; sequential.Parent(parent).data != ecs::hierarchy::no_parent; parent = sequential.Parent(parent).data) {
+            depth++;
+        }
+        REQUIRE(depth >= last_depth);
+        last_depth = depth;
+        REQUIRE(near(parallel.World(entity).data.x_, world.x_));
+        REQUIRE(near(world.rotation_, 0.1f * static_cast<float>(depth + 1)));
+        checked++;
+    });
+    REQUIRE(checked == ecs::core::MAX_ENTITY_COUNT);
+
+    SECTION("Benchmark hierarchy") {
+        BENCHMARK("Propagate a full hierarchy") {
+            sequential.Propagate();
+        };
+        ecs::core::Entity moved = 100;
+        BENCHMARK("Reparent and propagate") {
+            sequential.SetParent(moved, moved % 2 ? 1 : 2);
+            moved++;
+            sequential.Propagate();
+        };
+    }
+}
@@ -0,0 +1,175 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <logging/logging.h>
+#include <logging/binary_log.h>
+
+namespace {
+    size_t countLines(const std::string& text) {
+        size_t lines = 0;
+        for (const auto c : text) {
+            if (c == '\n') lines++;
+        }
+        return lines;
+    }
+}
+
+TEST_CASE("Synchronous logging", "[logging]") {
+    std::stringstream stream;
+    logging::Logger::SetStream(stream);
+
+    lLog(lInfo) << "Hello " << 42;
+
+    const auto text = stream.str();
+    REQUIRE(text.find("[Info] logging_tests.cpp:") != std::string::npos);
+    REQUIRE(text.find("Hello 42") != std::string::npos);
+    logging::Logger::SetStream(std::cout);
+}
+
+TEST_CASE("Asynchronous logging", "[logging]") {
+    std::stringstream stream;
+    logging::Logger::SetStream(stream);
+    logging::Logger::StartAsync();
+    REQUIRE(logging::AsyncLogger::Running());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 100; i++) {
+                lLog(lWarn) << "thread " << t << " line " << i;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logging::Logger::StopAsync();
+    REQUIRE(!logging::AsyncLogger::Running());
+
+    const auto text = stream.str();
+    REQUIRE(countLines(text) + logging::AsyncLogger::Dropped() == 400);
+    REQUIRE(text.find("thread 3 line 99") != std::string::npos);
+    logging::Logger::SetStream(std::cout);
+}
+
+TEST_CASE("Log ring buffer", "[logging]") {
+    auto ring = std::make_unique<logging::LogRingBuffer>();
+    logging::LogRecord record{};
+
+    for (size_t i = 0; i < logging::LOG_RING_CAPACITY; i++) {
+        REQUIRE(ring->Push(record));
+    }
+    REQUIRE(!ring->Push(record));
+    REQUIRE(ring->Drain([](const logging::LogRecord&) {}) == logging::LOG_RING_CAPACITY);
+    REQUIRE(ring->Empty());
+    REQUIRE(ring->Push(record));
+}
+
+TEST_CASE("Format", "[logging]") {
+    std::stringstream stream;
+
+    SECTION("Placeholders") {
+        logging::Format(stream, "{} + {} = {}", 1, 2.5, "3.5");
+        REQUIRE(stream.str() == "1 + 2.5 = 3.5");
+    }
+    SECTION("Escaped braces") {
+        logging::Format(stream, "{{{}}}", 7);
+        REQUIRE(stream.str() == "{7}");
+    }
+    SECTION("Missing and surplus arguments") {
+        logging::Format(stream, "{} {}", 1);
+        REQUIRE(stream.str() == "1 {}");
+        stream.str({});
+        logging::Format(stream, "none", 1);
+        REQUIRE(stream.str() == "none");
+    }
+}
+
+TEST_CASE("Basename", "[logging]") {
+    static_assert(logging::BasenameOffset("src/core/file.cpp") == 9);
+    static_assert(logging::BasenameOffset("C:\\src\\file.cpp") == 7);
+    static_assert(logging::BasenameOffset("file.cpp") == 0);
+    REQUIRE(std::string(lFile) == "logging_tests.cpp");
+}
+
+TEST_CASE("Lazy format logging", "[logging]") {
+    std::stringstream stream;
+    logging::Logger::SetStream(stream);
+    int evaluated = 0;
+    const auto expensive = [&evaluated]() {
+        evaluated++;
+        return std::string("expensive");
+    };
+
+    logging::Logger::SetLogLevel(lWarn);
+    lLogf(lDebug, "value {}", expensive());
+    REQUIRE(evaluated == 0);
+    REQUIRE(stream.str().empty());
+
+    lLogf(lError, "value {}", expensive());
+    REQUIRE(evaluated == 1);
+    REQUIRE(stream.str().find("value expensive") != std::string::npos);
+
+    logging::Logger::SetLogLevel(lAll);
+    logging::Logger::SetStream(std::cout);
+}
+
+TEST_CASE("Binary logging", "[logging]") {
+    const auto path = (std::filesystem::temp_directory_path() / "ecs_binary_log_test.bin").string();
+
+    lLogb(lInfo, "not written {}", 0);
+    REQUIRE(logging::BinaryLog::Open(path));
+
+    lLogb(lInfo, "int {} float {} text {}", -3, 1.5, "abc");
+    std::thread thread([]() {
+        lLogb(lWarn, "from thread {} {}", std::string("str"), true);
+    });
+    thread.join();
+    lLogb(lError, "no arguments");
+    logging::BinaryLog::Close();
+
+    std::ifstream input(path, std::ios::in | std::ios::binary);
+    std::stringstream output;
+    logging::BinaryLogReader reader;
+    REQUIRE(reader.Decode(input, output));
+
+    const auto text = output.str();
+    REQUIRE(countLines(text) == 3);
+    REQUIRE(text.find("[Info] logging_tests.cpp:") != std::string::npos);
+    REQUIRE(text.find("int -3 float 1.5 text abc") != std::string::npos);
+    REQUIRE(text.find("[Warn]") != std::string::npos);
+    REQUIRE(text.find("from thread str 1") != std::string::npos);
+    REQUIRE(text.find("no arguments") != std::string::npos);
+    REQUIRE(text.find("not written") == std::string::npos);
+
+    std::stringstream invalid("garbage");
+    REQUIRE(!reader.Decode(invalid, output));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Benchmark logging", "[logging][benchmark]") {
+    const auto path = (std::filesystem::temp_directory_path() / "ecs_binary_log_bench.bin").string();
+    std::stringstream stream;
+    logging::Logger::SetStream(stream);
+    REQUIRE(logging::BinaryLog::Open(path));
+
+    int value = 0;
+    BENCHMARK("Text lLogf") {
+        stream.str({});
+        lLogf(lInfo, "value {} ratio {}", value++, 0.5);
+    };
+    BENCHMARK("Binary lLogb") {
+        lLogb(lInfo, "value {} ratio {}", value++, 0.5);
+    };
+
+    logging::BinaryLog::Close();
+    logging::Logger::SetStream(std::cout);
+    std::filesystem::remove(path);
+}
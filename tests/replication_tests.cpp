@@ -0,0 +1,170 @@
+#include <cmath>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <ecs/replication/replication.h>
+
+namespace {
+    struct Position {
+        float x_{0}, y_{0};
+    };
+
+    struct Health {
+        int value{0};
+    };
+
+    struct Frozen {};
+}
+
+template<>
+struct ecs::core::TrackChanges<Position> {
+    static constexpr bool enabled = true;
+};
+
+template<>
+struct ecs::core::TrackChanges<Health> {
+    static constexpr bool enabled = true;
+};
+
+// positions are sent with 16 bits per axis
+template<>
+struct ecs::replication::Replicated<Position> {
+    static void Encode(BitWriter& writer, const Position& position) {
+        writer.WriteQuantized(position.x_, -1000, 1000, 16);
+        writer.WriteQuantized(position.y_, -1000, 1000, 16);
+    }
+
+    static void Decode(BitReader& reader, Position& position) {
+        position.x_ = reader.ReadQuantized(-1000, 1000, 16);
+        position.y_ = reader.ReadQuantized(-1000, 1000, 16);
+    }
+};
+
+TEST_CASE("Bit stream", "[replication]") {
+    ecs::replication::BitWriter writer;
+    writer.WriteBits(5, 3);
+    writer.WriteBool(true);
+    writer.WriteBits(0xABCDEF, 24);
+    writer.WriteQuantized(0.25f, 0, 1, 8);
+    REQUIRE(writer.Bits() == 36);
+    REQUIRE(writer.Bytes().size() == 5);
+    // an empty range has a single value
+    writer.WriteQuantized(3, 2, 2, 4);
+
+    ecs::replication::BitReader reader(writer.Bytes().data(), writer.Bytes().size());
+    REQUIRE(reader.ReadBits(3) == 5);
+    REQUIRE(reader.ReadBool());
+    REQUIRE(reader.ReadBits(24) == 0xABCDEF);
+    REQUIRE(reader.ReadQuantized(0, 1, 8) == 64.0f / 255);
+    REQUIRE(reader.ReadQuantized(2, 2, 4) == 2);
+    REQUIRE_FALSE(reader.Overrun());
+    REQUIRE(reader.ReadBits(8) == 0);
+    REQUIRE(reader.Overrun());
+}
+
+TEST_CASE("Replicate world", "[replication]") {
+    using World = ecs::core::EntityComponentSystem<int>;
+    World server_world;
+    World client_world;
+    for (auto* world : {&server_world, &client_world}) {
+        REQUIRE(world->RegisterComponent<Position>() == ecs::core::err::ok);
+        REQUIRE(world->RegisterComponent<Health>() == ecs::core::err::ok);
+        REQUIRE(world->RegisterComponent<Frozen>() == ecs::core::err::ok);
+    }
+
+    ecs::replication::ReplicationServer<int> server(server_world);
+    ecs::replication::ReplicationClient<int> client(client_world);
+    REQUIRE(server.Replicate<Position>() == ecs::core::err::ok);
+    REQUIRE(server.Replicate<Health>() == ecs::core::err::ok);
+    REQUIRE(server.Replicate<Health>() == ecs::core::err::already_registered);
+    REQUIRE(client.Replicate<Position>() == ecs::core::err::ok);
+    REQUIRE(client.Replicate<Health>() == ecs::core::err::ok);
+    REQUIRE(server.Replicate<Frozen>() == ecs::core::err::ok);
+    REQUIRE(client.Replicate<Frozen>() == ecs::core::err::ok);
+
+    auto [server_end, client_end] = ecs::replication::LoopbackTransport::Pair();
+
+    const auto first = server_world.CreateEntity().data;
+    const auto second = server_world.CreateEntity().data;
+    server_world.AddComponent(first, Position{10.5f, -20});
+    server_world.AddComponent(first, Health{100});
+    server_world.AddComponent(second, Health{50});
+    server_world.AddComponent(second, Frozen{});
+    server_world.Update(16);
+    server.Send(server_end);
+
+    REQUIRE(client_end.Pending() == 1);
+    REQUIRE(client.Receive(client_end) == ecs::core::err::ok);
+    const auto local_first = client.LocalEntity(first).data;
+    const auto local_second = client.LocalEntity(second).data;
+    REQUIRE(std::abs(client_world.GetComponent<Position>(local_first).data.x_ - 10.5f) < 0.02f);
+    REQUIRE(std::abs(client_world.GetComponent<Position>(local_first).data.y_ + 20) < 0.02f);
+    REQUIRE(client_world.GetComponent<Health>(local_first).data.value == 100);
+    REQUIRE(client_world.GetComponent<Health>(local_second).data.value == 50);
+    REQUIRE(client_world.HasComponent<Frozen>(local_second));
+    REQUIRE_FALSE(client_world.HasComponent<Frozen>(local_first));
+
+    SECTION("Deltas") {
+        // nothing changed: header and empty lists only
+        server_world.Update(16);
+        REQUIRE(server.Encode().size() <= 10);
+
+        server_world.GetMutableComponent<Health>(second).data->value = 40;
+        server_world.RemoveComponent<Position>(first);
+        server_world.RemoveComponent<Frozen>(second);
+        server_world.AddComponent(first, Frozen{});
+        const auto third = server_world.CreateEntity().data;
+        server_world.AddComponent(third, Health{1});
+        server_world.Update(16);
+        server.Send(server_end);
+
+        REQUIRE(client.Receive(client_end) == ecs::core::err::ok);
+        REQUIRE(client_world.GetComponent<Health>(local_second).data.value == 40);
+        REQUIRE(client_world.GetComponent<Position>(local_first).error == ecs::core::err::no_entity);
+        REQUIRE(client_world.HasComponent<Frozen>(local_first));
+        REQUIRE_FALSE(client_world.HasComponent<Frozen>(local_second));
+        REQUIRE(client_world.GetComponent<Health>(client.LocalEntity(third).data).data.value == 1);
+
+        server_world.DestroyEntity(second);
+        server_world.Update(16);
+        server.Send(server_end);
+        REQUIRE(client.Receive(client_end) == ecs::core::err::ok);
+        REQUIRE(client.LocalEntity(second).error == ecs::core::err::no_entity);
+        REQUIRE(client_world.GetSignature(local_second).error != ecs::core::err::ok);
+    }
+    SECTION("Late join") {
+        World late_world;
+        late_world.RegisterComponent<Position>();
+        late_world.RegisterComponent<Health>();
+        ecs::replication::ReplicationClient<int> late(late_world);
+        late.Replicate<Position>();
+        late.Replicate<Health>();
+        late_world.RegisterComponent<Frozen>();
+        late.Replicate<Frozen>();
+
+        server_world.Update(16);
+        server.SendFull(server_end);
+        REQUIRE(late.Receive(client_end) == ecs::core::err::ok);
+        REQUIRE(late_world.GetComponent<Health>(late.LocalEntity(second).data).data.value == 50);
+        REQUIRE(late_world.HasComponent<Frozen>(late.LocalEntity(second).data));
+    }
+    SECTION("Broken packets") {
+        const auto packet = server.EncodeFull();
+        REQUIRE(client.Apply(packet.data(), packet.size() / 2) == ecs::core::err::invalid_argument);
+
+        // a truncated delta is rejected before any of it is applied
+        server_world.GetMutableComponent<Health>(second).data->value = 40;
+        const auto third = server_world.CreateEntity().data;
+        server_world.AddComponent(third, Health{1});
+        server_world.Update(16);
+        const auto delta = server.Encode();
+        REQUIRE(client.Apply(delta.data(), delta.size() - 1) == ecs::core::err::invalid_argument);
+        REQUIRE(client_world.GetComponent<Health>(local_second).data.value == 50);
+        REQUIRE(client.LocalEntity(third).error == ecs::core::err::no_entity);
+        REQUIRE(client.Apply(delta.data(), delta.size()) == ecs::core::err::ok);
+        REQUIRE(client_world.GetComponent<Health>(local_second).data.value == 40);
+        ecs::replication::ReplicationClient<int> mismatch(client_world);
+        mismatch.Replicate<Health>();
+        REQUIRE(mismatch.Apply(packet.data(), packet.size()) == ecs::core::err::invalid_signature);
+    }
+}
@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ecs/spatial/broadphase.h>
+#include <ecs/spatial/spatial_hash.h>
+#include <ecs/spatial/spatial_index.h>
+
+namespace {
+    struct Position {
+        float x_{0}, y_{0};
+    };
+
+    struct Point {
+        float x, y;
+    };
+
+    using Pair = std::pair<ecs::core::Entity, ecs::core::Entity>;
+
+    std::vector<Pair> sortedPairs(const std::pmr::vector<ecs::spatial::CollisionPair>& pairs) {
+        std::vector<Pair> result;
+        for (const auto& pair : pairs) {
+            result.emplace_back(std::min(pair.first, pair.second), std::max(pair.first, pair.second));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<Pair> bruteForcePairs(ecs::core::EntityComponentSystem<int>& world) {
+        std::vector<std::pair<ecs::core::Entity, ecs::spatial::Aabb>> boxes;
+        world.ForEachComponent<ecs::spatial::Aabb>([&boxes](ecs::core::Entity entity, const ecs::spatial::Aabb& box) {
+            boxes.emplace_back(entity, box);
+        });
+        std::vector<Pair> result;
+        for (size_t first = 0; first < boxes.size(); first++) {
+            for (size_t second = first + 1; second < boxes.size(); second++) {
+                const auto& a = boxes[first].second;
+                const auto& b = boxes[second].second;
+                if (a.min_x_ <= b.max_x_ && b.min_x_ <= a.max_x_ && a.min_y_ <= b.max_y_ && b.min_y_ <= a.max_y_) {
+                    result.emplace_back(std::min(boxes[first].first, boxes[second].first), std::max(boxes[first].first, boxes[second].first));
+                }
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    // counts the collision batches of a broadphase
+    struct PairsObserver : ecs::event::IObserver {
+        size_t batches{0};
+        const ecs::spatial::CollisionPairs* pairs{nullptr};
+
+        virtual void Notify(const ecs::event::Message& message) override {
+            batches++;
+            pairs = message.GetData<const ecs::spatial::CollisionPairs*>();
+        }
+    };
+
+    ecs::spatial::Aabb box(float x, float y, float size) {
+        return {x, y, x + size, y + size};
+    }
+
+    std::vector<ecs::core::Entity> sorted(std::vector<ecs::core::Entity> entities) {
+        std::sort(entities.begin(), entities.end());
+        return entities;
+    }
+
+    std::vector<ecs::core::Entity> bruteForceRadius(const std::vector<Point>& points, float x, float y, float radius) {
+        std::vector<ecs::core::Entity> found;
+        for (ecs::core::Entity entity = 0; entity < points.size(); entity++) {
+            const auto dx = points[entity].x - x;
+            const auto dy = points[entity].y - y;
+            if (dx * dx + dy * dy <= radius * radius) {
+                found.push_back(entity);
+            }
+        }
+        return found;
+    }
+}
+
+template<>
+struct ecs::core::TrackChanges<Position> {
+    static constexpr bool enabled = true;
+};
+
+TEST_CASE("Spatial hash", "[spatial]") {
+    // few buckets so that cells collide
+    ecs::spatial::SpatialHash hash(10, 16);
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> coordinate(-200, 200);
+    std::vector<Point> points;
+    for (ecs::core::Entity entity = 0; entity < 500; entity++) {
+        points.push_back({coordinate(random), coordinate(random)});
+        REQUIRE(hash.Insert(entity, points.back().x, points.back().y) == ecs::core::err::ok);
+    }
+    REQUIRE(hash.Insert(3, 0, 0) == ecs::core::err::already_registered);
+    REQUIRE(hash.Size() == 500);
+
+    const auto check = [&]() {
+        for (const auto radius : {5.0f, 25.0f, 80.0f}) {
+            const Point center{coordinate(random), coordinate(random)};
+            std::vector<ecs::core::Entity> found;
+            hash.QueryRadius(center.x, center.y, radius, [&found](ecs::core::Entity entity) { found.push_back(entity); });
+            REQUIRE(sorted(found) == bruteForceRadius(points, center.x, center.y, radius));
+        }
+    };
+    check();
+
+    // small moves stay in their cell, large ones change buckets
+    for (ecs::core::Entity entity = 0; entity < 500; entity++) {
+        const auto step = entity % 2 ? 0.5f : 50.0f;
+        points[entity] = {points[entity].x + step, points[entity].y - step};
+        REQUIRE(hash.Move(entity, points[entity].x, points[entity].y) == ecs::core::err::ok);
+    }
+    check();
+
+    std::vector<ecs::core::Entity> boxed;
+    hash.QueryAabb(-50, -20, 30, 40, [&boxed](ecs::core::Entity entity) { boxed.push_back(entity); });
+    std::vector<ecs::core::Entity> expected;
+    for (ecs::core::Entity entity = 0; entity < 500; entity++) {
+        if (points[entity].x >= -50 && points[entity].x <= 30 && points[entity].y >= -20 && points[entity].y <= 40) {
+            expected.push_back(entity);
+        }
+    }
+    REQUIRE(sorted(boxed) == expected);
+
+    REQUIRE(hash.Remove(7) == ecs::core::err::ok);
+    REQUIRE(hash.Remove(7) == ecs::core::err::no_entity);
+    REQUIRE(hash.Move(7, 0, 0) == ecs::core::err::no_entity);
+    size_t count = 0;
+    hash.QueryRadius(points[7].x, points[7].y, 0.01f, [&count](ecs::core::Entity entity) { count += entity == 7; });
+    REQUIRE(count == 0);
+    REQUIRE(hash.Size() == 499);
+}
+
+TEST_CASE("Spatial index", "[spatial]") {
+    ecs::core::EntityComponentSystem<int> world;
+    REQUIRE(world.RegisterComponent<Position>() == ecs::core::err::ok);
+    ecs::spatial::SpatialIndex<int, Position> index(world, 16);
+
+    std::vector<ecs::core::Entity> entities;
+    for (int column = 0; column < 10; column++) {
+        const auto entity = world.CreateEntity().data;
+        entities.push_back(entity);
+        REQUIRE(world.AddComponent(entity, Position{column * 10.0f, 0}) == ecs::core::err::ok);
+    }
+    REQUIRE(index.Update() == ecs::core::err::ok);
+    REQUIRE(index.Hash().Size() == 10);
+
+    const auto near = [&index](float x, float y, float radius) {
+        std::vector<ecs::core::Entity> found;
+        index.QueryRadius(x, y, radius, [&found](ecs::core::Entity entity) { found.push_back(entity); });
+        return sorted(found);
+    };
+    REQUIRE(near(0, 0, 15) == std::vector<ecs::core::Entity>{entities[0], entities[1]});
+
+    world.Update(16);
+    world.GetMutableComponent<Position>(entities[9]).data->x_ = 5;
+    REQUIRE(world.RemoveComponent<Position>(entities[1]) == ecs::core::err::ok);
+    REQUIRE(index.Update() == ecs::core::err::ok);
+    REQUIRE(near(0, 0, 15) == std::vector<ecs::core::Entity>{entities[0], entities[9]});
+    REQUIRE(index.Hash().Size() == 9);
+
+    // moving leaves the structure alone, the removal check is skipped
+    const auto revision = world.StructureRevision();
+    world.Update(16);
+    world.GetMutableComponent<Position>(entities[9]).data->x_ = 6;
+    REQUIRE(index.Update() == ecs::core::err::ok);
+    REQUIRE(world.StructureRevision() == revision);
+    REQUIRE(near(0, 0, 15) == std::vector<ecs::core::Entity>{entities[0], entities[9]});
+
+    world.DestroyEntity(entities[0]);
+    REQUIRE(world.StructureRevision() != revision);
+    REQUIRE(index.Update() == ecs::core::err::ok);
+    REQUIRE(near(0, 0, 15) == std::vector<ecs::core::Entity>{entities[9]});
+    REQUIRE(index.Hash().Size() == 8);
+
+    // an entity id reused with a new position is indexed again
+    const auto reused = world.CreateEntity().data;
+    REQUIRE(world.AddComponent(reused, Position{1, 1}) == ecs::core::err::ok);
+    REQUIRE(index.Update() == ecs::core::err::ok);
+    REQUIRE(index.Hash().Size() == 9);
+    REQUIRE(near(0, 0, 15) == sorted({entities[9], reused}));
+}
+
+TEST_CASE("Spatial hash benchmark", "[spatial]") {
+    // 100k entities wandering on a 2000 x 2000 field, cells match the query radius
+    static constexpr ecs::core::Entity count = 100000;
+    ecs::spatial::SpatialHash hash(20, 1 << 14);
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> coordinate(0, 2000);
+    std::uniform_real_distribution<float> step(-1, 1);
+    std::vector<Point> points;
+    for (ecs::core::Entity entity = 0; entity < count; entity++) {
+        points.push_back({coordinate(random), coordinate(random)});
+        hash.Insert(entity, points.back().x, points.back().y);
+    }
+
+    BENCHMARK("Move 100k entities") {
+        for (ecs::core::Entity entity = 0; entity < count; entity++) {
+            points[entity].x += step(random);
+            points[entity].y += step(random);
+            hash.Move(entity, points[entity].x, points[entity].y);
+        }
+    };
+    BENCHMARK("100 radius queries over 100k entities") {
+        size_t found = 0;
+        for (ecs::core::Entity entity = 0; entity < count; entity += 1000) {
+            hash.QueryRadius(points[entity].x, points[entity].y, 20, [&found](ecs::core::Entity) { found++; });
+        }
+        return found;
+    };
+    BENCHMARK("100 radius queries by scanning 100k entities") {
+        size_t found = 0;
+        for (ecs::core::Entity entity = 0; entity < count; entity += 1000) {
+            for (const auto& point : points) {
+                const auto dx = point.x - points[entity].x;
+                const auto dy = point.y - points[entity].y;
+                found += dx * dx + dy * dy <= 20 * 20;
+            }
+        }
+        return found;
+    };
+}
+
+TEST_CASE("Sweep and prune", "[spatial]") {
+    ecs::core::EntityComponentSystem<int> world;
+    REQUIRE((world.RegisterComponent<ecs::spatial::Aabb, ecs::core::SparseSet>()) == ecs::core::err::ok);
+    auto broadphase = std::make_shared<ecs::spatial::SweepAndPrune<int>>(world);
+    REQUIRE(world.RegisterSystem(broadphase) == ecs::core::err::ok);
+    ecs::core::Signature signature;
+    signature.set(world.GetComponentType<ecs::spatial::Aabb>());
+    REQUIRE(world.SetSystemSignature<ecs::spatial::SweepAndPrune<int>>(signature) == ecs::core::err::ok);
+    auto observer = std::make_shared<PairsObserver>();
+    broadphase->PublishPairs(1);
+    REQUIRE(world.GetEventBus().Subscribe(1, observer));
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> coordinate(0, 400);
+    std::uniform_real_distribution<float> size(1, 20);
+    std::uniform_real_distribution<float> step(-3, 3);
+    std::vector<ecs::core::Entity> entities;
+    for (size_t index = 0; index < 1000; index++) {
+        const auto entity = world.CreateEntity().data;
+        entities.push_back(entity);
+        REQUIRE(world.AddComponent(entity, box(coordinate(random), coordinate(random), size(random))) == ecs::core::err::ok);
+    }
+    // touching borders overlap
+    REQUIRE(world.AddComponent(world.CreateEntity().data, box(-100, -100, 10)) == ecs::core::err::ok);
+    REQUIRE(world.AddComponent(world.CreateEntity().data, box(-90, -90, 10)) == ecs::core::err::ok);
+    // unbounded along x, e.g. a ground plane, sorted first and reaching past every box
+    const auto infinity = std::numeric_limits<float>::infinity();
+    const auto ground = world.CreateEntity().data;
+    REQUIRE(world.AddComponent(ground, ecs::spatial::Aabb{-infinity, -100, infinity, -95}) == ecs::core::err::ok);
+
+    world.Update(16);
+    REQUIRE_FALSE(broadphase->Pairs().empty());
+    REQUIRE(sortedPairs(broadphase->Pairs()) == bruteForcePairs(world));
+    // all pairs of a frame arrive as one event
+    REQUIRE(observer->batches == 1);
+    REQUIRE(observer->pairs == &broadphase->Pairs());
+
+    for (size_t frame = 0; frame < 3; frame++) {
+        for (const auto entity : entities) {
+            auto* bounds = world.GetMutableComponent<ecs::spatial::Aabb>(entity).data;
+            if (!bounds) {
+                continue;
+            }
+            const auto dx = step(random);
+            const auto dy = step(random);
+            *bounds = {bounds->min_x_ + dx, bounds->min_y_ + dy, bounds->max_x_ + dx, bounds->max_y_ + dy};
+        }
+        world.DestroyEntity(entities[frame]);
+        world.RemoveComponent<ecs::spatial::Aabb>(entities[10 + frame]);
+        world.Update(16);
+        REQUIRE(sortedPairs(broadphase->Pairs()) == bruteForcePairs(world));
+    }
+    REQUIRE(observer->batches == 4);
+
+    SECTION("Benchmark broadphase") {
+        ecs::core::EntityComponentSystem<int> full;
+        REQUIRE((full.RegisterComponent<ecs::spatial::Aabb, ecs::core::SparseSet>()) == ecs::core::err::ok);
+        ecs::spatial::SweepAndPrune<int> sweep(full);
+        std::uniform_real_distribution<float> field(0, 2000);
+        for (ecs::core::Entity index = 0; index < ecs::core::MAX_ENTITY_COUNT; index++) {
+            full.AddComponent(full.CreateEntity().data, box(field(random), field(random), size(random)));
+        }
+        sweep.update(16);
+
+        BENCHMARK("Sweep and prune 4096 moving boxes") {
+            full.ForEachComponent<ecs::spatial::Aabb>([&](ecs::core::Entity, ecs::spatial::Aabb& bounds) {
+                const auto dx = step(random);
+                bounds.min_x_ += dx;
+                bounds.max_x_ += dx;
+            });
+            sweep.update(16);
+            return sweep.Pairs().size();
+        };
+    }
+}
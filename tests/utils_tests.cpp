@@ -0,0 +1,190 @@
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <utils/clock_chrono.h>
+#include <utils/timer.h>
+#include <utils/profiler.h>
+#include <utils/fixed_step_loop.h>
+#include <utils/memory.h>
+
+TEST_CASE("Chrono", "[clock]") {
+    utils::clock::Chrono chrono;
+
+    chrono.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    const auto ms = chrono.Stop();
+
+    REQUIRE(ms >= 2);
+    REQUIRE(chrono.TimePassedNs() >= 2000000);
+    REQUIRE(chrono.TimePassedNs() / 1000000 == ms);
+}
+
+TEST_CASE("Timer", "[timer]") {
+    utils::ChronoTimer timer;
+
+    REQUIRE(!timer.IsStarted());
+    timer.Start();
+    REQUIRE(timer.IsStarted());
+    timer.Stop();
+    REQUIRE(!timer.IsStarted());
+}
+
+TEST_CASE("Profiler", "[profiler]") {
+    utils::profiler::Profiler::Clear();
+
+    SECTION("Disabled") {
+        utils::profiler::Profiler::Enable(false);
+        {
+            ECS_PROFILE_SCOPE("disabled");
+        }
+        REQUIRE(utils::profiler::Profiler::ZoneCount() == 0);
+    }
+    SECTION("Chrome trace") {
+        utils::profiler::Profiler::Enable(true);
+        {
+            ECS_PROFILE_SCOPE("frame");
+            {
+                ECS_PROFILE_SCOPE("physics \"step\"");
+            }
+            std::thread worker([]() {
+                ECS_PROFILE_SCOPE("worker");
+            });
+            worker.join();
+        }
+        utils::profiler::Profiler::Enable(false);
+        REQUIRE(utils::profiler::Profiler::ZoneCount() == 3);
+
+        std::stringstream stream;
+        utils::profiler::Profiler::ExportChromeTrace(stream);
+        const auto trace = stream.str();
+        REQUIRE(trace.rfind("{\"traceEvents\":[", 0) == 0);
+        REQUIRE(trace.find("\"name\":\"frame\",\"ph\":\"X\"") != std::string::npos);
+        REQUIRE(trace.find("physics \\\"step\\\"") != std::string::npos);
+        REQUIRE(trace.find("\"name\":\"worker\"") != std::string::npos);
+    }
+    SECTION("Timestamps keep nanoseconds") {
+        const auto second = utils::clock::TicksPerSecond();
+        const uint64_t origin = 1000;
+        utils::profiler::Profiler::Record("origin", origin, origin + second);
+        utils::profiler::Profiler::Record("late", origin + 2 * second, origin + 3 * second);
+
+        std::stringstream stream;
+        utils::profiler::Profiler::ExportChromeTrace(stream);
+        const auto trace = stream.str();
+        REQUIRE(trace.find("\"name\":\"late\",\"ph\":\"X\",\"pid\":0,\"tid\":") != std::string::npos);
+        REQUIRE(trace.find(",\"ts\":2000000.000,\"dur\":1000000.000}") != std::string::npos);
+        REQUIRE(trace.find("e+") == std::string::npos);
+    }
+    SECTION("Ring overwrites old zones") {
+        utils::profiler::Profiler::Enable(true);
+        for (size_t i = 0; i < utils::profiler::PROFILER_ZONE_CAPACITY + 10; i++) {
+            ECS_PROFILE_SCOPE("zone");
+        }
+        utils::profiler::Profiler::Enable(false);
+        REQUIRE(utils::profiler::Profiler::ZoneCount() == utils::profiler::PROFILER_ZONE_CAPACITY);
+    }
+}
+
+TEST_CASE("FixedStepLoop", "[loop]") {
+    using namespace std::chrono_literals;
+    utils::FixedStepLoop loop(10ms, 3);
+    const auto start = utils::FixedStepLoop::Clock::now();
+    size_t steps = 0;
+    double alpha = -1;
+    const auto step = [&steps](std::chrono::nanoseconds dt) {
+        REQUIRE(dt == 10ms);
+        steps++;
+    };
+    const auto render = [&alpha](double a) { alpha = a; };
+
+    SECTION("Steps and interpolation") {
+        REQUIRE(loop.Tick(start, step, render) == 0);
+        REQUIRE(alpha == 0.0);
+        REQUIRE(loop.Tick(start + 25ms, step, render) == 2);
+        REQUIRE(steps == 2);
+        REQUIRE(alpha == 0.5);
+        REQUIRE(loop.Tick(start + 30ms, step, render) == 1);
+        REQUIRE(alpha == 0.0);
+        REQUIRE(loop.Steps() == 3);
+    }
+    SECTION("Catch up limit") {
+        loop.Tick(start, step, render);
+        REQUIRE(loop.Tick(start + 1s + 4ms, step, render) == 3);
+        REQUIRE(loop.DroppedSteps() == 97);
+        REQUIRE(loop.Alpha() == 0.4);
+    }
+    SECTION("Run") {
+        utils::FixedStepLoop fast(1ms);
+        size_t ran = 0;
+        const auto before = utils::FixedStepLoop::Clock::now();
+        fast.Run([&](std::chrono::nanoseconds) {
+            if (++ran == 20) fast.Stop();
+        }, [](double) {});
+        REQUIRE(ran >= 20);
+        REQUIRE(utils::FixedStepLoop::Clock::now() - before >= 19ms);
+    }
+    SECTION("Run renders between steps") {
+        utils::FixedStepLoop fast(2ms);
+        size_t ran = 0;
+        size_t frames = 0;
+        bool interpolated = false;
+        fast.Run([&](std::chrono::nanoseconds) {
+            if (++ran == 20) fast.Stop();
+        }, [&](double a) {
+            frames++;
+            interpolated |= a > 0.0;
+        });
+        REQUIRE(frames > ran);
+        REQUIRE(interpolated);
+        // render does not block, the idle passes wait for the next step
+        REQUIRE(frames <= 2 * ran + 1);
+    }
+    SECTION("Frame cap") {
+        utils::FixedStepLoop fast(1ms);
+        fast.SetFrameCap(5ms);
+        size_t ran = 0;
+        size_t frames = 0;
+        fast.Run([&](std::chrono::nanoseconds) {
+            if (++ran == 20) fast.Stop();
+        }, [&](double) { frames++; });
+        REQUIRE(frames < ran);
+    }
+}
+
+TEST_CASE("Memory resources", "[memory]") {
+    SECTION("Counting") {
+        utils::memory::CountingResource counting;
+        {
+            std::pmr::vector<int> values(&counting);
+            values.resize(100);
+            REQUIRE(counting.Stats().allocations == 1);
+            REQUIRE(counting.Stats().bytes_in_use == 100 * sizeof(int));
+        }
+        REQUIRE(counting.Stats().deallocations == 1);
+        REQUIRE(counting.Stats().bytes_in_use == 0);
+    }
+    SECTION("Frame arena") {
+        utils::memory::CountingResource counting;
+        utils::memory::FrameArena arena(256, &counting);
+        // chunks are only max_align_t aligned, stronger alignment would make the padding depend on the address
+        void* first = arena.allocate(100, 8);
+        void* aligned = arena.allocate(100, alignof(std::max_align_t));
+        REQUIRE(reinterpret_cast<uintptr_t>(aligned) % alignof(std::max_align_t) == 0);
+        REQUIRE(arena.allocate(200) != nullptr);
+        REQUIRE(arena.Used() == 400);
+        REQUIRE(counting.Stats().allocations == 2);
+
+        arena.Reset();
+        REQUIRE(arena.Used() == 0);
+        REQUIRE(arena.allocate(100, 8) == first);
+        REQUIRE(arena.allocate(100, alignof(std::max_align_t)) == aligned);
+        REQUIRE(arena.allocate(200) != nullptr);
+        REQUIRE(counting.Stats().allocations == 2);
+        REQUIRE(arena.Capacity() == 512);
+    }
+}
@@ -0,0 +1,34 @@
+#include <fstream>
+#include <iostream>
+
+#include <logging/binary_log.h>
+
+// Converts a binary log written by lLogb into text
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <log.bin> [output.txt]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::in | std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (argc > 2) {
+        file.open(argv[2], std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "cannot open " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+
+    logging::BinaryLogReader reader;
+    if (!reader.Decode(input, argc > 2 ? file : std::cout)) {
+        std::cerr << argv[1] << " is not a valid binary log" << std::endl;
+        return 1;
+    }
+    return 0;
+}